@@ -0,0 +1,275 @@
+#include "assincrono.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// Populacao compartilhada do motor assincrono: tamanho individuos ordenados por fitness.
+// Os genes ficam em tamanho + num_threads posicoes (slots): cada thread monta o seu individuo em um slot
+// reserva fora da populacao e, ao inseri-lo, fica com o slot do individuo que saiu, entao nenhum gene
+// é copiado. A ordem, a idade e os leitores de cada slot sao protegidos por um unico mutex, mantido somente
+// durante a escolha dos pais e a insercao (O(tamanho) operacoes, sem copia de genes e sem alocacao).
+// Os pais ficam marcados (leitores) enquanto os seus genes sao lidos fora da trava, e um slot marcado
+// nunca é escolhido para sair da populacao.
+class MotorAssincrono {
+public:
+    MotorAssincrono(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros, PoolThreads& pool);
+
+    //gera e avalia a populacao inicial em paralelo (os mesmos individuos do motor geracional)
+    void inicializar();
+
+    //cada thread do pool repete geracao, decodificacao e insercao ate um criterio de parada
+    void evoluir();
+
+    //busca local no melhor individuo e montagem do resultado
+    ResultadoBRKGA finalizar();
+
+private:
+    //medicoes de uma thread (somadas no resultado no fim da evolucao)
+    struct MedicoesTrabalhador {
+        double tempo_reproducao_s = 0.0;
+        double tempo_avaliacao_s = 0.0;
+    };
+
+    double segundos_desde_inicio() const;
+    const float* genes_slot(int slot) const { return genes.data() + (size_t)slot * num_genes; }
+    float* genes_slot(int slot) { return genes.data() + (size_t)slot * num_genes; }
+    void laco_trabalhador(int trabalhador, int id_thread);
+    void escolher_pais(const FluxoAleatorio& fluxo, int& pai1, int& pai2);
+    int inserir(int slot, long long evento, int pai1, int pai2); //retorna o novo slot reserva da thread
+    void registrar_melhor(long long evento); //com a trava
+    void verificar_parada(long long evento);
+
+    const SCPCSInstance& instancia;
+    ParametrosBRKGA parametros;
+    PoolThreads& pool;
+    int num_genes;
+    int tamanho_populacao;
+    int tamanho_elite;
+    int novos_por_geracao;   //tamanho_populacao - tamanho_elite: insercoes de uma geracao equivalente
+    int mutantes_por_geracao;
+    int num_trabalhadores;   //threads do pool que evoluem a populacao
+    long long limite_eventos;
+
+    std::vector<float> genes; //(tamanho_populacao + num_trabalhadores) slots x num_genes
+    std::vector<double> fitness;     //por slot
+    std::vector<long long> nascimento; //por slot: ordem de insercao (a idade)
+    std::vector<int> leitores;       //por slot: threads lendo os genes como pai
+    std::vector<int> ordem;          //slots da populacao em ordem crescente de fitness
+    std::vector<int> reservas;       //slot reserva de cada trabalhador (indice da tarefa, nao da thread do pool)
+    std::mutex trava;
+
+    std::atomic<long long> proximo_evento{0};
+    std::atomic<bool> parar{false};
+    MotivoParada motivo = PARADA_GERACOES;
+    long long evento_melhor = 0;
+    long long insercoes = 0;
+
+    std::vector<ContextoDecodificador> contextos;
+    std::vector<MedicoesTrabalhador> medicoes;
+    CacheFitness cache;
+
+    ResultadoBRKGA resultado;
+    std::chrono::steady_clock::time_point inicio;
+    double melhor = std::numeric_limits<double>::max();
+};
+
+MotorAssincrono::MotorAssincrono(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros, PoolThreads& pool)
+    : instancia(instancia), parametros(parametros), pool(pool), num_genes(instancia.num_subconjuntos),
+      tamanho_populacao(parametros.tamanho_populacao), tamanho_elite(parametros.tamanho_elite),
+      contextos(pool.num_threads()), medicoes(pool.num_threads()), cache(parametros.tamanho_cache_fitness),
+      inicio(std::chrono::steady_clock::now()) {
+    novos_por_geracao = std::max(1, tamanho_populacao - tamanho_elite);
+    mutantes_por_geracao = std::min(novos_por_geracao, (int)(tamanho_populacao * parametros.percentual_mutantes));
+    //cada thread marca no maximo dois slots, entao com num_trabalhadores <= novos_por_geracao / 2 sempre ha
+    //fora da elite um individuo sem leitores para sair
+    num_trabalhadores = std::max(1, std::min(pool.num_threads(), novos_por_geracao / 2));
+    limite_eventos = (long long)parametros.num_geracoes * novos_por_geracao;
+
+    int num_slots = tamanho_populacao + num_trabalhadores;
+    genes.resize((size_t)num_slots * num_genes);
+    fitness.assign(num_slots, 0.0);
+    nascimento.assign(num_slots, 0);
+    leitores.assign(num_slots, 0);
+    ordem.reserve(tamanho_populacao + 1); //a insercao passa por tamanho_populacao + 1 antes da remocao
+    ordem.resize(tamanho_populacao);
+    for (int t = 0; t < num_trabalhadores; t++) reservas.push_back(tamanho_populacao + t);
+}
+
+double MotorAssincrono::segundos_desde_inicio() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+void MotorAssincrono::inicializar() {
+    uint64_t semente = parametros.semente;
+    auto inicio_avaliacao = std::chrono::steady_clock::now();
+    //fluxo i = id_fluxo(0, i, tamanho_populacao) do motor geracional
+    pool.executar(tamanho_populacao, [&](int i, int id_thread) {
+        gerar_cromossomo_aleatorio(genes_slot(i), num_genes, FluxoAleatorio(semente, (uint64_t)i));
+        fitness[i] = decodificar(Intervalo<float>(genes_slot(i), genes_slot(i) + num_genes), instancia, contextos[id_thread],
+                                 parametros.modo_decodificador, &cache);
+    });
+    resultado.tempo_avaliacao_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio_avaliacao).count();
+    resultado.decodificacoes += tamanho_populacao;
+
+    for (int i = 0; i < tamanho_populacao; i++) {
+        ordem[i] = i;
+        nascimento[i] = i - tamanho_populacao; //a populacao inicial é mais antiga que qualquer insercao
+    }
+    std::stable_sort(ordem.begin(), ordem.end(), [this](int a, int b) { return fitness[a] < fitness[b]; });
+    registrar_melhor(0);
+}
+
+//registra o instante da melhor solucao e do alvo (geracao = insercoes / novos_por_geracao)
+void MotorAssincrono::registrar_melhor(long long evento) {
+    double atual = fitness[ordem[0]];
+    if (atual >= melhor) return;
+    melhor = atual;
+    evento_melhor = evento;
+    resultado.tempo_melhor_s = segundos_desde_inicio();
+    resultado.geracao_melhor = (int)(insercoes / novos_por_geracao);
+    resultado.convergencia.push_back({0, resultado.geracao_melhor, resultado.tempo_melhor_s, melhor});
+    if (resultado.tempo_alvo_s < 0 && parametros.custo_alvo >= 0 && melhor <= parametros.custo_alvo) {
+        resultado.tempo_alvo_s = resultado.tempo_melhor_s;
+    }
+}
+
+//com a trava: criterios que dependem da populacao (o numero de eventos e o tempo sao verificados por cada thread)
+void MotorAssincrono::verificar_parada(long long evento) {
+    if (parametros.parar_no_alvo && resultado.tempo_alvo_s >= 0) {
+        motivo = PARADA_ALVO;
+        parar.store(true, std::memory_order_relaxed);
+    } else if (parametros.max_geracoes_sem_melhoria > 0 &&
+               evento - evento_melhor >= (long long)parametros.max_geracoes_sem_melhoria * novos_por_geracao) {
+        motivo = PARADA_ESTAGNACAO;
+        parar.store(true, std::memory_order_relaxed);
+    }
+}
+
+//pai1 na elite e pai2 fora dela, sorteados pelo posto nas posicoes n e n + 1 do fluxo (como no motor geracional)
+void MotorAssincrono::escolher_pais(const FluxoAleatorio& fluxo, int& pai1, int& pai2) {
+    int posto1 = fluxo.indice(num_genes, tamanho_elite);
+    int posto2 = tamanho_elite + fluxo.indice(num_genes + 1, tamanho_populacao - tamanho_elite);
+    std::lock_guard<std::mutex> guarda(trava);
+    pai1 = ordem[posto1];
+    pai2 = ordem[posto2];
+    leitores[pai1]++;
+    leitores[pai2]++;
+}
+
+int MotorAssincrono::inserir(int slot, long long evento, int pai1, int pai2) {
+    std::lock_guard<std::mutex> guarda(trava);
+    if (pai1 >= 0) {
+        leitores[pai1]--;
+        leitores[pai2]--;
+    }
+    nascimento[slot] = insercoes++;
+
+    //o novo individuo entra depois dos de mesmo fitness
+    double valor = fitness[slot];
+    auto posicao = std::upper_bound(ordem.begin(), ordem.end(), valor, [this](double v, int s) { return v < fitness[s]; });
+    ordem.insert(posicao, slot);
+
+    //sai o mais antigo fora da elite sem leitores (a elite nunca sai)
+    int posto_saida = -1;
+    for (int r = tamanho_elite; r <= tamanho_populacao; r++) {
+        int s = ordem[r];
+        if (leitores[s] == 0 && (posto_saida < 0 || nascimento[s] < nascimento[ordem[posto_saida]])) posto_saida = r;
+    }
+    int livre = ordem[posto_saida];
+    ordem.erase(ordem.begin() + posto_saida);
+
+    registrar_melhor(evento);
+    verificar_parada(evento);
+    return livre;
+}
+
+//trabalhador identifica o slot reserva e id_thread o contexto do decodificador e as medicoes da thread que o executa
+void MotorAssincrono::laco_trabalhador(int trabalhador, int id_thread) {
+    ContextoDecodificador& ctx = contextos[id_thread];
+    MedicoesTrabalhador& medicao = medicoes[id_thread];
+    uint64_t semente = parametros.semente;
+    while (!parar.load(std::memory_order_relaxed)) {
+        long long evento = proximo_evento.fetch_add(1, std::memory_order_relaxed);
+        if (evento >= limite_eventos) {
+            parar.store(true, std::memory_order_relaxed);
+            break;
+        }
+        if (parametros.tempo_limite_s > 0 && segundos_desde_inicio() >= parametros.tempo_limite_s) {
+            {
+                std::lock_guard<std::mutex> guarda(trava);
+                motivo = PARADA_TEMPO;
+            }
+            parar.store(true, std::memory_order_relaxed);
+            break;
+        }
+
+        //o evento define o fluxo do individuo (depois dos fluxos da populacao inicial) e se ele é mutante:
+        //os mutantes_por_geracao primeiros de cada bloco de novos_por_geracao eventos
+        auto inicio_reproducao = std::chrono::steady_clock::now();
+        FluxoAleatorio fluxo(semente, (uint64_t)tamanho_populacao + (uint64_t)evento);
+        int slot = reservas[trabalhador];
+        int pai1 = -1, pai2 = -1;
+        if (evento % novos_por_geracao < mutantes_por_geracao) {
+            gerar_cromossomo_aleatorio(genes_slot(slot), num_genes, fluxo);
+        } else {
+            escolher_pais(fluxo, pai1, pai2);
+            gerar_filho(genes_slot(slot), genes_slot(pai1), genes_slot(pai2), num_genes, fluxo);
+        }
+        auto inicio_avaliacao = std::chrono::steady_clock::now();
+        fitness[slot] = decodificar(Intervalo<float>(genes_slot(slot), genes_slot(slot) + num_genes), instancia, ctx,
+                                    parametros.modo_decodificador, &cache);
+        auto fim_avaliacao = std::chrono::steady_clock::now();
+        medicao.tempo_reproducao_s += std::chrono::duration<double>(inicio_avaliacao - inicio_reproducao).count();
+        medicao.tempo_avaliacao_s += std::chrono::duration<double>(fim_avaliacao - inicio_avaliacao).count();
+
+        reservas[trabalhador] = inserir(slot, evento, pai1, pai2);
+    }
+}
+
+void MotorAssincrono::evoluir() {
+    //uma tarefa por trabalhador (particoes de um indice); com menos trabalhadores que threads, as tarefas podem cair
+    //em threads de id maior que num_trabalhadores, por isso o slot reserva é escolhido pelo indice da tarefa
+    pool.executar(num_trabalhadores, [&](int trabalhador, int id_thread) { laco_trabalhador(trabalhador, id_thread); }, 1);
+}
+
+ResultadoBRKGA MotorAssincrono::finalizar() {
+    int indice_melhor = ordem[0];
+    resultado.custo_antes_busca_local = fitness[indice_melhor];
+
+    decodificar(Intervalo<float>(genes_slot(indice_melhor), genes_slot(indice_melhor) + num_genes), instancia, contextos[0],
+                parametros.modo_decodificador);
+    BuscaLocal busca;
+    busca.carregar(instancia, contextos[0].selecionados);
+    resultado.custo = busca.otimizar();
+    resultado.solucao = busca.solucao();
+
+    //tempos de reproducao e avaliacao somados entre as threads (tempo ocupado, nao de relogio)
+    for (const MedicoesTrabalhador& medicao : medicoes) {
+        resultado.tempo_reproducao_s += medicao.tempo_reproducao_s;
+        resultado.tempo_avaliacao_s += medicao.tempo_avaliacao_s;
+    }
+    resultado.decodificacoes += insercoes;
+    resultado.acertos_cache = cache.acertos();
+    long long feitas = resultado.decodificacoes - resultado.acertos_cache;
+    if (feitas > 0) resultado.tempo_economizado_cache_s = resultado.acertos_cache * resultado.tempo_avaliacao_s / feitas;
+
+    resultado.geracoes = (int)(insercoes / novos_por_geracao);
+    resultado.motivo_parada = motivo;
+    resultado.tempo_s = segundos_desde_inicio();
+    if (resultado.tempo_alvo_s < 0 && parametros.custo_alvo >= 0 && resultado.custo <= parametros.custo_alvo) {
+        resultado.tempo_alvo_s = resultado.tempo_s; //alvo atingido somente com a busca local final
+    }
+    return resultado;
+}
+
+ResultadoBRKGA brkga_assincrono(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros, PoolThreads& pool) {
+    MotorAssincrono motor(instancia, parametros, pool);
+    motor.inicializar();
+    motor.evoluir();
+    return motor.finalizar();
+}
@@ -0,0 +1,18 @@
+#ifndef ASSINCRONO_HPP
+#define ASSINCRONO_HPP
+
+#include "brkga.hpp"
+
+// Executa o BRKGA em estado estacionario, sem barreira entre geracoes: cada thread do pool repete, ate a parada,
+// gerar um individuo (mutante ou filho de um pai da elite e um de fora dela, com RHO), decodifica-lo e inseri-lo
+// na populacao ordenada compartilhada, sem esperar as demais threads.
+// A semantica da elite e dos mutantes é a do BRKGA geracional: a cada tamanho_populacao - tamanho_elite insercoes
+// (uma "geracao"), a mesma fracao de mutantes e filhos é gerada, a elite (os tamanho_elite melhores) nunca sai
+// da populacao e cada insercao remove o individuo mais antigo fora da elite, entao os de fora da elite sao
+// renovados a cada geracao como no motor geracional.
+// Criterios de parada: num_geracoes (em insercoes equivalentes), tempo limite, alvo e estagnacao
+// (max_geracoes_sem_melhoria geracoes equivalentes); a etapa de busca local na elite e o reinicio por diversidade
+// nao sao usados (somente a busca local final). Com mais de uma thread, o resultado depende do ritmo das threads.
+ResultadoBRKGA brkga_assincrono(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros, PoolThreads& pool);
+
+#endif // ASSINCRONO_HPP
@@ -0,0 +1,777 @@
+#include "scp_cs_data.hpp"
+#include "decodificador.hpp"
+#include "pool_threads.hpp"
+#include "busca_local.hpp"
+#include "reducao.hpp"
+#include "assincrono.hpp"
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <filesystem>
+#include <sstream>
+#include <set>
+#include <cmath>
+#include <functional>
+#include <cctype>
+#include <climits>
+#include <limits>
+#include <ctime>
+
+//microbenchmark do decodificador: mede quantas decodificacoes por segundo sao feitas em cada instancia
+//os cromossomos sao gerados com semente fixa, para que execucoes diferentes decodifiquem as mesmas chaves
+
+using namespace std;
+
+//contador global de alocacoes: substitui o operator new padrao somente neste executavel,
+//para verificar que o decodificador com contexto reaproveitado nao aloca memoria em regime permanente
+static std::atomic<long long> contador_alocacoes{0};
+
+//(noinline evita um falso positivo do -Wmismatched-new-delete do gcc ao combinar malloc/free com new/delete)
+__attribute__((noinline)) void* operator new(std::size_t tamanho) {
+    contador_alocacoes.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(tamanho ? tamanho : 1)) return ptr;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* ptr) noexcept { std::free(ptr); }
+__attribute__((noinline)) void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+#define SEMENTE 12345 //semente fixa dos cromossomos de teste
+#define NUM_CROMOSSOMOS 64 //quantidade de cromossomos distintos decodificados em cada rodada
+#define TEMPO_MINIMO 1.0 //tempo minimo (em segundos) de medicao por instancia
+#define TAMANHO_POPULACAO 140 //individuos avaliados por rodada no teste de escalabilidade
+#define AQUECIMENTO 2 //repeticoes descartadas antes de cada medicao da suite
+#define REPETICOES_PADRAO 10 //repeticoes medidas por funcao na suite
+
+double medir_decodificacoes_por_segundo(const SCPCSInstance& instancia, ModoDecodificador modo) {
+    std::mt19937_64 rng(SEMENTE);
+    std::uniform_real_distribution<double> dist(0.01, 0.99);
+
+    vector<vector<float>> cromossomos(NUM_CROMOSSOMOS, vector<float>(instancia.num_subconjuntos));
+    for (auto& genes : cromossomos) {
+        for (float& gene : genes) {
+            gene = dist(rng);
+        }
+    }
+
+    //aquecimento: uma rodada completa fora da medicao (dimensiona os buffers do contexto)
+    ContextoDecodificador ctx;
+    double soma_custos = 0.0;
+    for (const auto& genes : cromossomos) {
+        soma_custos += decodificar(genes, instancia, ctx, modo);
+    }
+    long long alocacoes_inicio = contador_alocacoes.load();
+
+    long long decodificacoes = 0;
+    auto inicio = std::chrono::steady_clock::now();
+    double decorrido = 0.0;
+    while (decorrido < TEMPO_MINIMO) {
+        for (const auto& genes : cromossomos) {
+            soma_custos += decodificar(genes, instancia, ctx, modo);
+        }
+        decodificacoes += NUM_CROMOSSOMOS;
+        decorrido = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    //a soma dos custos é exibida para evitar que o compilador descarte as chamadas
+    //e para conferir que diferentes versoes do decodificador produzem os mesmos custos
+    cout << "soma dos custos por rodada: " << soma_custos / (decodificacoes / NUM_CROMOSSOMOS + 1) << endl;
+    cout << "alocacoes por decodificacao: "
+         << (double)(contador_alocacoes.load() - alocacoes_inicio) / decodificacoes << endl;
+    return decodificacoes / decorrido;
+}
+
+//escalabilidade forte: avalia sempre a mesma populacao no pool com 1, 2, 4, ... ate max_threads threads
+void medir_escalabilidade(const SCPCSInstance& instancia, ModoDecodificador modo, int max_threads) {
+    std::mt19937_64 rng(SEMENTE);
+    std::uniform_real_distribution<double> dist(0.01, 0.99);
+
+    vector<vector<float>> populacao(TAMANHO_POPULACAO, vector<float>(instancia.num_subconjuntos));
+    for (auto& genes : populacao) {
+        for (float& gene : genes) {
+            gene = dist(rng);
+        }
+    }
+    vector<double> fitness(TAMANHO_POPULACAO);
+
+    vector<int> contagens_threads;
+    for (int t = 1; t < max_threads; t *= 2) {
+        contagens_threads.push_back(t);
+    }
+    contagens_threads.push_back(max_threads);
+
+    double vazao_uma_thread = 0.0;
+    for (int num_threads : contagens_threads) {
+        PoolThreads pool(num_threads);
+        vector<ContextoDecodificador> contextos(num_threads);
+        auto avaliar = [&](int i, int id_thread) {
+            fitness[i] = decodificar(populacao[i], instancia, contextos[id_thread], modo);
+        };
+        pool.executar(TAMANHO_POPULACAO, avaliar); //aquecimento
+
+        long long avaliacoes = 0;
+        auto inicio = std::chrono::steady_clock::now();
+        double decorrido = 0.0;
+        while (decorrido < TEMPO_MINIMO) {
+            pool.executar(TAMANHO_POPULACAO, avaliar);
+            avaliacoes += TAMANHO_POPULACAO;
+            decorrido = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        }
+        double vazao = avaliacoes / decorrido;
+        if (num_threads == 1) vazao_uma_thread = vazao;
+        cout << "  threads: " << num_threads << "  avaliacoes/s: " << vazao
+             << "  speedup: " << vazao / vazao_uma_thread
+             << "  eficiencia: " << vazao / vazao_uma_thread / num_threads << endl;
+    }
+}
+
+//tempo de carregamento de todas as instancias de um diretorio: leitura do texto, construcao dos conflitos
+//e carregamento do arquivo binario equivalente (gravado em um diretorio temporario)
+void medir_tempo_leitura(const string& diretorio, int k_threshold) {
+    vector<string> arquivos;
+    for (const auto& entrada : std::filesystem::directory_iterator(diretorio)) {
+        if (entrada.path().extension() == ".txt") {
+            arquivos.push_back(entrada.path().string());
+        }
+    }
+    std::sort(arquivos.begin(), arquivos.end());
+    string nome_binario = (std::filesystem::temp_directory_path() / "benchmark_instancia.bin").string();
+
+    auto ms_desde = [](std::chrono::steady_clock::time_point inicio) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+    };
+    double total_texto = 0.0, total_conflitos = 0.0, total_binario = 0.0;
+
+    cout << "instancia;leitura_texto_ms;conflitos_ms;carga_binaria_ms" << endl;
+    for (const string& nome_arquivo : arquivos) {
+        //as mensagens das funcoes de leitura sao descartadas durante a medicao
+        std::ostringstream descarte;
+        auto* saida_original = cout.rdbuf(descarte.rdbuf());
+
+        SCPCSInstance inst;
+        auto inicio = std::chrono::steady_clock::now();
+        bool ok = ler_instancia_scpcs(nome_arquivo, inst, k_threshold);
+        double tempo_texto = ms_desde(inicio);
+
+        inicio = std::chrono::steady_clock::now();
+        if (ok) calcular_custos_conflito(inst, k_threshold);
+        double tempo_conflitos = ms_desde(inicio);
+
+        ok = ok && salvar_instancia_binaria(nome_binario, inst);
+        SCPCSInstance inst_binaria;
+        inicio = std::chrono::steady_clock::now();
+        ok = ok && carregar_instancia_binaria(nome_binario, inst_binaria, k_threshold);
+        double tempo_binario = ms_desde(inicio);
+
+        cout.rdbuf(saida_original);
+        if (!ok) {
+            cout << nome_arquivo << ";erro;erro;erro" << endl;
+            continue;
+        }
+        total_texto += tempo_texto;
+        total_conflitos += tempo_conflitos;
+        total_binario += tempo_binario;
+        cout << nome_arquivo << ";" << tempo_texto << ";" << tempo_conflitos << ";" << tempo_binario << endl;
+    }
+    cout << "total;" << total_texto << ";" << total_conflitos << ";" << total_binario << endl;
+    std::filesystem::remove(nome_binario);
+}
+
+//estatisticas das amostras de uma medicao (desvio padrao amostral)
+struct Estatisticas {
+    double media = 0.0;
+    double desvio = 0.0;
+    double minimo = 0.0;
+    double mediana = 0.0;
+    double maximo = 0.0;
+};
+
+Estatisticas calcular_estatisticas(vector<double> amostras) {
+    Estatisticas est;
+    if (amostras.empty()) return est;
+    std::sort(amostras.begin(), amostras.end());
+    size_t n = amostras.size();
+    for (double x : amostras) est.media += x;
+    est.media /= n;
+    for (double x : amostras) est.desvio += (x - est.media) * (x - est.media);
+    est.desvio = n > 1 ? std::sqrt(est.desvio / (n - 1)) : 0.0;
+    est.minimo = amostras.front();
+    est.maximo = amostras.back();
+    est.mediana = n % 2 ? amostras[n / 2] : (amostras[n / 2 - 1] + amostras[n / 2]) / 2.0;
+    return est;
+}
+
+//executa AQUECIMENTO rodadas descartadas e depois repeticoes rodadas medidas; cada rodada devolve uma amostra
+vector<double> repetir(int repeticoes, const std::function<double()>& rodada) {
+    for (int r = 0; r < AQUECIMENTO; ++r) rodada();
+    vector<double> amostras;
+    for (int r = 0; r < repeticoes; ++r) amostras.push_back(rodada());
+    return amostras;
+}
+
+void imprimir_medicao(const string& instancia, const string& medida, const string& unidade, const vector<double>& amostras) {
+    Estatisticas est = calcular_estatisticas(amostras);
+    cout << instancia << ";" << medida << ";" << unidade << ";" << amostras.size() << ";" << est.media << ";"
+         << est.desvio << ";" << est.minimo << ";" << est.mediana << ";" << est.maximo << endl;
+}
+
+//suite reprodutivel: mede separadamente cada etapa do solver em cada instancia, com aquecimento,
+//repeticoes e estatisticas. Os cromossomos vem da semente fixa, e as solucoes usadas no custo e na busca local
+//sao as decodificadas a partir deles, entao todas as execucoes medem exatamente o mesmo trabalho
+void executar_suite(const vector<string>& arquivos, int k_threshold, int repeticoes) {
+    double soma_conferencia = 0.0; //consome os resultados para que o compilador nao descarte as chamadas
+    auto ms_desde = [](std::chrono::steady_clock::time_point inicio) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+    };
+
+    cout << "instancia;medida;unidade;repeticoes;media;desvio;minimo;mediana;maximo" << endl;
+    for (const string& nome_arquivo : arquivos) {
+        //as mensagens da leitura e da construcao dos conflitos sao descartadas durante a medicao
+        std::ostringstream descarte;
+        auto* saida_original = cout.rdbuf(descarte.rdbuf());
+        SCPCSInstance inst;
+        bool ok = ler_instancia_scpcs(nome_arquivo, inst, k_threshold);
+        vector<double> amostras_leitura, amostras_conflitos, amostras_intersecoes, amostras_derivacao;
+        if (ok) {
+            amostras_leitura = repetir(repeticoes, [&]() {
+                SCPCSInstance lida;
+                auto inicio = std::chrono::steady_clock::now();
+                ler_instancia_scpcs(nome_arquivo, lida, k_threshold);
+                double tempo = ms_desde(inicio);
+                soma_conferencia += lida.num_subconjuntos;
+                return tempo;
+            });
+            //a construcao dos conflitos sobrescreve o grafo, entao pode ser repetida na mesma instancia
+            amostras_conflitos = repetir(repeticoes, [&]() {
+                auto inicio = std::chrono::steady_clock::now();
+                calcular_custos_conflito(inst, k_threshold);
+                double tempo = ms_desde(inicio);
+                soma_conferencia += inst.conflitos.vizinhos.size();
+                return tempo;
+            });
+            //varredura de k: as intersecoes sao calculadas uma vez e os conflitos de cada k derivados delas
+            IntersecoesSubconjuntos intersecoes;
+            amostras_intersecoes = repetir(repeticoes, [&]() {
+                auto inicio = std::chrono::steady_clock::now();
+                calcular_intersecoes(inst, k_threshold, intersecoes);
+                double tempo = ms_desde(inicio);
+                soma_conferencia += intersecoes.vizinhos.size();
+                return tempo;
+            });
+            amostras_derivacao = repetir(repeticoes, [&]() {
+                auto inicio = std::chrono::steady_clock::now();
+                aplicar_conflitos_k(inst, intersecoes, k_threshold);
+                double tempo = ms_desde(inicio);
+                soma_conferencia += inst.conflitos.vizinhos.size();
+                return tempo;
+            });
+        }
+        cout.rdbuf(saida_original);
+        if (!ok) {
+            cout << nome_arquivo << ";erro;;;;;;;" << endl;
+            continue;
+        }
+        imprimir_medicao(nome_arquivo, "ler_instancia_scpcs", "ms", amostras_leitura);
+        imprimir_medicao(nome_arquivo, "calcular_custos_conflito", "ms", amostras_conflitos);
+        imprimir_medicao(nome_arquivo, "calcular_intersecoes", "ms", amostras_intersecoes);
+        imprimir_medicao(nome_arquivo, "aplicar_conflitos_k", "ms", amostras_derivacao);
+
+        std::mt19937_64 rng(SEMENTE);
+        std::uniform_real_distribution<double> dist(0.01, 0.99);
+        vector<vector<float>> cromossomos(NUM_CROMOSSOMOS, vector<float>(inst.num_subconjuntos));
+        for (auto& genes : cromossomos) {
+            for (float& gene : genes) {
+                gene = dist(rng);
+            }
+        }
+
+        //cada rodada decodifica os NUM_CROMOSSOMOS cromossomos com o contexto reaproveitado
+        for (ModoDecodificador modo : {DECODIFICADOR_VARREDURA, DECODIFICADOR_FILA_PRIORIDADE}) {
+            ContextoDecodificador ctx;
+            imprimir_medicao(nome_arquivo,
+                             modo == DECODIFICADOR_VARREDURA ? "decodificar[varredura]" : "decodificar[fila]",
+                             "decodificacoes/s", repetir(repeticoes, [&]() {
+                auto inicio = std::chrono::steady_clock::now();
+                for (const auto& genes : cromossomos) {
+                    soma_conferencia += decodificar(genes, inst, ctx, modo);
+                }
+                return NUM_CROMOSSOMOS / (ms_desde(inicio) / 1000.0);
+            }));
+        }
+
+        vector<std::set<int>> solucoes(NUM_CROMOSSOMOS);
+        for (int c = 0; c < NUM_CROMOSSOMOS; ++c) {
+            decodificar(cromossomos[c], inst, &solucoes[c]);
+        }
+
+        imprimir_medicao(nome_arquivo, "calcular_custo_solucao", "us/chamada", repetir(repeticoes, [&]() {
+            auto inicio = std::chrono::steady_clock::now();
+            for (const auto& solucao : solucoes) {
+                soma_conferencia += calcular_custo_solucao(solucao, inst);
+            }
+            return ms_desde(inicio) * 1000.0 / NUM_CROMOSSOMOS;
+        }));
+
+        //a copia da solucao de entrada faz parte da chamada (busca_local_remocao recebe o conjunto por valor)
+        imprimir_medicao(nome_arquivo, "busca_local_remocao", "us/chamada", repetir(repeticoes, [&]() {
+            auto inicio = std::chrono::steady_clock::now();
+            for (const auto& solucao : solucoes) {
+                double custo = 0.0;
+                soma_conferencia += busca_local_remocao(solucao, inst, custo).size() + custo;
+            }
+            return ms_desde(inicio) * 1000.0 / NUM_CROMOSSOMOS;
+        }));
+    }
+    cout << "soma de conferencia: " << soma_conferencia << endl;
+}
+
+//efeito da reducao em todas as instancias de um diretorio: subconjuntos e elementos antes e depois,
+//quantos subconjuntos cada regra removeu e o tempo da reducao (sem a leitura e os conflitos)
+void medir_reducao(const string& diretorio, int k_threshold) {
+    vector<string> arquivos;
+    for (const auto& entrada : std::filesystem::directory_iterator(diretorio)) {
+        if (entrada.path().extension() == ".txt") {
+            arquivos.push_back(entrada.path().string());
+        }
+    }
+    std::sort(arquivos.begin(), arquivos.end());
+
+    long long total_n = 0, total_n_reduzido = 0, total_m = 0, total_m_reduzido = 0;
+    cout << "instancia;n;n_reduzido;m;m_reduzido;fixados;implicados;sem_elementos;dominados;custo_fixo;rodadas;razao_n;razao_m;reducao_ms;custo_excedido" << endl;
+    for (const string& nome_arquivo : arquivos) {
+        std::ostringstream descarte;
+        auto* saida_original = cout.rdbuf(descarte.rdbuf());
+        SCPCSInstance inst;
+        bool ok = ler_instancia_scpcs(nome_arquivo, inst, k_threshold);
+        if (ok) calcular_custos_conflito(inst, k_threshold);
+        cout.rdbuf(saida_original);
+        if (!ok) {
+            cout << nome_arquivo << ";erro" << endl;
+            continue;
+        }
+
+        SCPCSInstance reduzida;
+        ReducaoInstancia reducao;
+        auto inicio = std::chrono::steady_clock::now();
+        bool reduziu = reduzir_instancia(inst, reduzida, reducao);
+        double tempo_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+        int n_reduzido = reduziu ? reduzida.num_subconjuntos : inst.num_subconjuntos;
+        int m_reduzido = reduziu ? reduzida.num_elementos : inst.num_elementos;
+
+        total_n += inst.num_subconjuntos;
+        total_n_reduzido += n_reduzido;
+        total_m += inst.num_elementos;
+        total_m_reduzido += m_reduzido;
+        cout << nome_arquivo << ";" << inst.num_subconjuntos << ";" << n_reduzido << ";" << inst.num_elementos << ";" << m_reduzido
+             << ";" << reducao.fixados.size() << ";" << reducao.elementos_implicados << ";" << reducao.removidos_vazios << ";" << reducao.removidos_dominados
+             << ";" << reducao.custo_fixo << ";" << reducao.rodadas
+             << ";" << (double)n_reduzido / inst.num_subconjuntos << ";" << (double)m_reduzido / inst.num_elementos
+             << ";" << tempo_ms << ";" << reducao.custo_excedido << endl;
+    }
+    cout << "total;" << total_n << ";" << total_n_reduzido << ";" << total_m << ";" << total_m_reduzido << ";;;;;;;"
+         << (total_n > 0 ? (double)total_n_reduzido / total_n : 0.0) << ";"
+         << (total_m > 0 ? (double)total_m_reduzido / total_m : 0.0) << ";;" << endl;
+}
+
+//instancia aleatoria pequena o bastante para a enumeracao exaustiva (n <= 18, m <= 25), com a mesma forma das
+//lidas do arquivo: cada elemento é coberto por 1 a 9 subconjuntos; com custos_grandes, os custos ficam perto de
+//INT_MAX (os custos ajustados pela reducao passam do limite)
+static SCPCSInstance gerar_instancia_pequena(std::mt19937_64& rng, bool custos_grandes) {
+    auto sortear = [&](int minimo, int maximo) { return std::uniform_int_distribution<int>(minimo, maximo)(rng); };
+    SCPCSInstance inst;
+    inst.num_elementos = sortear(5, 25);
+    inst.num_subconjuntos = sortear(4, 18);
+    int n = inst.num_subconjuntos;
+    inst.custos.resize(n);
+    for (int& custo : inst.custos) custo = custos_grandes ? INT_MAX - sortear(0, 20) : sortear(1, 20);
+
+    const int coberturas_maximas[] = {2, 4, 6, 9};
+    vector<int> todos(n);
+    MatrizCSR<int>& lista = inst.lista_incidencia;
+    lista.inicio.assign(1, 0);
+    for (int e = 0; e < inst.num_elementos; ++e) {
+        for (int j = 0; j < n; ++j) todos[j] = j;
+        std::shuffle(todos.begin(), todos.end(), rng);
+        int coberturas = sortear(1, std::min(n, coberturas_maximas[sortear(0, 3)]));
+        std::sort(todos.begin(), todos.begin() + coberturas);
+        lista.indices.insert(lista.indices.end(), todos.begin(), todos.begin() + coberturas);
+        lista.inicio.push_back((int)lista.indices.size());
+    }
+    MatrizCSR<int>& matriz = inst.matriz_incidencia;
+    vector<vector<int>> elementos(n);
+    for (int e = 0; e < inst.num_elementos; ++e) {
+        for (int j : lista[e]) elementos[j].push_back(e);
+    }
+    matriz.inicio.assign(1, 0);
+    for (const vector<int>& linha : elementos) {
+        matriz.indices.insert(matriz.indices.end(), linha.begin(), linha.end());
+        matriz.inicio.push_back((int)matriz.indices.size());
+    }
+    construir_incidencia_bits(inst);
+    return inst;
+}
+
+//custo otimo por enumeracao de todos os subconjuntos de colunas que cobrem todos os elementos
+static double custo_otimo(const SCPCSInstance& inst, std::set<int>& melhor_solucao) {
+    int n = inst.num_subconjuntos;
+    vector<uint32_t> cobertura(n, 0);
+    for (int j = 0; j < n; ++j) {
+        for (int e : inst.matriz_incidencia[j]) cobertura[j] |= 1u << e;
+    }
+    uint32_t todos = inst.num_elementos == 32 ? ~0u : (1u << inst.num_elementos) - 1;
+    double melhor = std::numeric_limits<double>::infinity();
+    for (uint32_t escolha = 0; escolha < (1u << n); ++escolha) {
+        uint32_t coberto = 0;
+        for (int j = 0; j < n; ++j) {
+            if (escolha >> j & 1) coberto |= cobertura[j];
+        }
+        if (coberto != todos) continue;
+        std::set<int> solucao;
+        for (int j = 0; j < n; ++j) {
+            if (escolha >> j & 1) solucao.insert(j);
+        }
+        double custo = calcular_custo_solucao(solucao, inst);
+        if (custo < melhor) {
+            melhor = custo;
+            melhor_solucao = solucao;
+        }
+    }
+    return melhor;
+}
+
+//confere a reducao por forca bruta em instancias aleatorias pequenas: o otimo da original deve ser o otimo da
+//reduzida somado ao custo fixo, e a solucao otima da reduzida, levada para a original, deve ter o custo otimo.
+//Uma em cada oito instancias tem custos perto de INT_MAX, para exercitar o descarte por custo excedido.
+//k < 0 alterna k entre 0, 1 e 2. Retorna o numero de falhas
+long long verificar_reducao(int num_instancias, uint64_t semente, int k_threshold) {
+    std::mt19937_64 rng(semente);
+    long long reduzidas = 0, sem_reducao = 0, descartadas = 0, falhas = 0;
+    for (int i = 0; i < num_instancias; ++i) {
+        int k = k_threshold >= 0 ? k_threshold : i % 3;
+        SCPCSInstance inst = gerar_instancia_pequena(rng, i % 8 == 7);
+        std::ostringstream descarte;
+        auto* saida_original = cout.rdbuf(descarte.rdbuf());
+        calcular_custos_conflito(inst, k);
+        SCPCSInstance reduzida;
+        ReducaoInstancia reducao;
+        bool reduziu = reduzir_instancia(inst, reduzida, reducao);
+        cout.rdbuf(saida_original);
+        if (!reduziu) {
+            (reducao.custo_excedido ? descartadas : sem_reducao)++;
+            continue;
+        }
+        reduzidas++;
+
+        std::set<int> solucao, solucao_reduzida;
+        double otimo = custo_otimo(inst, solucao);
+        double otimo_reduzida = custo_otimo(reduzida, solucao_reduzida);
+        double custo_restaurada = calcular_custo_solucao(solucao_original(reducao, solucao_reduzida), inst);
+        if (otimo != otimo_reduzida + reducao.custo_fixo || custo_restaurada != otimo) {
+            falhas++;
+            cout << "FALHA na instancia " << i << " (k = " << k << "): otimo " << otimo << ", reduzida " << otimo_reduzida
+                 << " + " << reducao.custo_fixo << ", restaurada " << custo_restaurada << "; n " << inst.num_subconjuntos
+                 << " -> " << reduzida.num_subconjuntos << ", m " << inst.num_elementos << " -> " << reduzida.num_elementos
+                 << " (" << reducao.fixados.size() << " fixados, " << reducao.elementos_implicados << " implicados, "
+                 << reducao.removidos_vazios << " sem elementos, " << reducao.removidos_dominados << " dominados)" << endl;
+        }
+    }
+    cout << "instancias: " << num_instancias << "  reduzidas: " << reduzidas << "  sem reducao: " << sem_reducao
+         << "  descartadas (custo acima de INT_MAX): " << descartadas << "  falhas: " << falhas << endl;
+    return falhas;
+}
+
+//melhor custo registrado ate o instante tempo_s (curva de convergencia; o primeiro ponto é a populacao inicial)
+static double melhor_ate(const ResultadoBRKGA& resultado, double tempo_s) {
+    double melhor = resultado.convergencia.empty() ? 0.0 : resultado.convergencia.front().melhor;
+    for (const PontoConvergencia& ponto : resultado.convergencia) {
+        if (ponto.tempo_s <= tempo_s) melhor = std::min(melhor, ponto.melhor);
+    }
+    return melhor;
+}
+
+//motor geracional x assincrono com o mesmo tempo limite e as mesmas threads: vazao, utilizacao dos nucleos
+//(tempo de CPU do processo / (tempo de relogio x nucleos usados), com as threads ociosas bloqueadas no pool)
+//e o melhor custo a 25%, 50%, 75% e 100% do tempo, para as sementes 1..num_sementes
+//alem da populacao padrao, roda uma populacao pequena (10 individuos, elite 6) com um quarto do tempo: com 4 novos
+//individuos por geracao, o motor assincrono usa menos trabalhadores que as threads do pool
+void comparar_motores(const vector<string>& arquivos, int k_threshold, double tempo_limite_s, int num_threads, int num_sementes) {
+    int nucleos = std::max(1, std::min(num_threads, (int)std::thread::hardware_concurrency()));
+    PoolThreads pool(num_threads);
+    struct Configuracao {
+        int populacao;
+        int elite;
+        double tempo_limite_s;
+    };
+    const Configuracao configuracoes[] = {{140, 28, tempo_limite_s}, {10, 6, tempo_limite_s / 4}};
+    cout << "instancia;motor;populacao;elite;semente;threads;nucleos;tempo_s;decodificacoes_s;utilizacao;melhor_25;melhor_50;melhor_75;melhor_100;final"
+         << endl;
+    for (const string& nome_arquivo : arquivos) {
+        std::ostringstream descarte;
+        auto* saida_original = cout.rdbuf(descarte.rdbuf());
+        SCPCSInstance inst;
+        bool ok = ler_instancia_scpcs(nome_arquivo, inst, k_threshold);
+        if (ok) calcular_custos_conflito(inst, k_threshold);
+        cout.rdbuf(saida_original);
+        if (!ok) continue;
+
+        for (const Configuracao& configuracao : configuracoes) {
+            for (int semente = 1; semente <= num_sementes; semente++) {
+                for (int assincrono = 0; assincrono <= 1; assincrono++) {
+                    ParametrosBRKGA parametros;
+                    parametros.tamanho_populacao = configuracao.populacao;
+                    parametros.tamanho_elite = configuracao.elite;
+                    parametros.semente = semente;
+                    parametros.num_geracoes = INT_MAX / 2; //somente o tempo limite encerra a evolucao
+                    parametros.tempo_limite_s = configuracao.tempo_limite_s;
+
+                    std::clock_t cpu_inicio = std::clock();
+                    auto inicio = std::chrono::steady_clock::now();
+                    ResultadoBRKGA resultado = assincrono ? brkga_assincrono(inst, parametros, pool) : brkga(inst, parametros, pool);
+                    double tempo_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+                    double cpu_s = (double)(std::clock() - cpu_inicio) / CLOCKS_PER_SEC;
+
+                    cout << nome_arquivo << ";" << (assincrono ? "assincrono" : "geracional") << ";" << configuracao.populacao << ";"
+                         << configuracao.elite << ";" << semente << ";" << num_threads
+                         << ";" << nucleos << ";" << tempo_s << ";" << resultado.decodificacoes / tempo_s << ";" << cpu_s / (tempo_s * nucleos);
+                    for (double fracao : {0.25, 0.5, 0.75, 1.0}) cout << ";" << melhor_ate(resultado, fracao * configuracao.tempo_limite_s);
+                    cout << ";" << resultado.custo << endl;
+                }
+            }
+        }
+    }
+}
+
+//confere todas as instanciacoes do decodificador (modelo de conflitos x largura dos indices x tipo do custo, nos dois
+//modos) contra a referencia: conflitos esparsos, indices de 32 bits, custo real, varredura sem a incidencia em bits.
+//Os mesmos cromossomos devem produzir o mesmo custo, a mesma sequencia de subconjuntos e o mesmo custo recalculado
+//da solucao; as variantes que nao se aplicam a instancia (ver variante_suportada) sao listadas e puladas.
+//Retorna o numero de divergencias
+long long verificar_variantes(const vector<string>& arquivos, int k_threshold) {
+    long long divergencias = 0, verificadas = 0;
+    cout << "instancia;variante;modo;cromossomos;custos_diferentes;solucoes_diferentes;custo_solucao_diferente" << endl;
+    for (const string& nome_arquivo : arquivos) {
+        std::ostringstream descarte;
+        auto* saida_original = cout.rdbuf(descarte.rdbuf());
+        SCPCSInstance inst;
+        bool ok = ler_instancia_scpcs(nome_arquivo, inst, k_threshold);
+        if (ok) calcular_custos_conflito(inst, k_threshold);
+        cout.rdbuf(saida_original);
+        if (!ok) {
+            cout << nome_arquivo << ";erro" << endl;
+            continue;
+        }
+
+        std::mt19937_64 rng(SEMENTE);
+        std::uniform_real_distribution<double> dist(0.01, 0.99);
+        vector<vector<float>> cromossomos(NUM_CROMOSSOMOS, vector<float>(inst.num_subconjuntos));
+        for (auto& genes : cromossomos) {
+            for (float& gene : genes) {
+                gene = dist(rng);
+            }
+        }
+
+        SCPCSInstance referencia = inst;
+        referencia.incidencia_bits = MatrizBits();
+        VarianteDecodificador variante_referencia;
+        if (!especializar_instancia(referencia, variante_referencia)) {
+            variante_referencia.conflitos = CONFLITOS_NENHUM; //instancia sem o grafo de conflitos
+            especializar_instancia(referencia, variante_referencia);
+        }
+        vector<double> custos_referencia(NUM_CROMOSSOMOS);
+        vector<vector<int>> selecionados_referencia(NUM_CROMOSSOMOS);
+        vector<std::set<int>> solucoes(NUM_CROMOSSOMOS);
+        ContextoDecodificador ctx_referencia;
+        for (int c = 0; c < NUM_CROMOSSOMOS; ++c) {
+            custos_referencia[c] = decodificar(cromossomos[c], referencia, ctx_referencia, DECODIFICADOR_VARREDURA);
+            selecionados_referencia[c] = ctx_referencia.selecionados;
+            solucoes[c].insert(ctx_referencia.selecionados.begin(), ctx_referencia.selecionados.end());
+        }
+
+        for (ModeloConflitos conflitos : {CONFLITOS_NENHUM, CONFLITOS_ESPARSOS, CONFLITOS_DENSOS}) {
+            for (LarguraIndices indices : {INDICES_32, INDICES_16}) {
+                for (TipoCusto custo : {CUSTO_REAL, CUSTO_INTEIRO}) {
+                    VarianteDecodificador variante;
+                    variante.conflitos = conflitos;
+                    variante.indices = indices;
+                    variante.custo = custo;
+                    if (!especializar_instancia(inst, variante)) {
+                        cout << nome_arquivo << ";" << descrever_variante(variante) << ";nao suportada;;;;" << endl;
+                        continue;
+                    }
+                    int custo_solucao_diferente = 0;
+                    for (const std::set<int>& solucao : solucoes) {
+                        if (calcular_custo_solucao(solucao, inst) != calcular_custo_solucao(solucao, referencia)) custo_solucao_diferente++;
+                    }
+                    for (ModoDecodificador modo : {DECODIFICADOR_VARREDURA, DECODIFICADOR_FILA_PRIORIDADE}) {
+                        ContextoDecodificador ctx;
+                        int custos_diferentes = 0, solucoes_diferentes = 0;
+                        for (int c = 0; c < NUM_CROMOSSOMOS; ++c) {
+                            if (decodificar(cromossomos[c], inst, ctx, modo) != custos_referencia[c]) custos_diferentes++;
+                            if (ctx.selecionados != selecionados_referencia[c]) solucoes_diferentes++;
+                        }
+                        cout << nome_arquivo << ";" << descrever_variante(variante) << ";"
+                             << (modo == DECODIFICADOR_VARREDURA ? "varredura" : "fila") << ";" << NUM_CROMOSSOMOS << ";"
+                             << custos_diferentes << ";" << solucoes_diferentes << ";" << custo_solucao_diferente << endl;
+                        divergencias += custos_diferentes + solucoes_diferentes + custo_solucao_diferente;
+                        verificadas++;
+                    }
+                }
+            }
+        }
+    }
+    cout << "instanciacoes verificadas: " << verificadas << "  divergencias: " << divergencias << endl;
+    return divergencias;
+}
+
+int main(int argc, char* argv[]) {
+    int k_threshold = 1; //valor k (tolerancia de elementos em comum)
+
+    //modo de tempo de carregamento: ./benchmark --leitura [diretorio]
+    if (argc > 1 && string(argv[1]) == "--leitura") {
+        medir_tempo_leitura(argc > 2 ? argv[2] : "instancias", k_threshold);
+        return 0;
+    }
+
+    //efeito da reducao: ./benchmark --reducao [diretorio] [-k K]
+    if (argc > 1 && string(argv[1]) == "--reducao") {
+        string diretorio = "instancias";
+        int proximo = 2;
+        if (argc > 2 && string(argv[2]) != "-k") {
+            diretorio = argv[2];
+            proximo = 3;
+        }
+        if (argc > proximo + 1 && string(argv[proximo]) == "-k") k_threshold = atoi(argv[proximo + 1]);
+        medir_reducao(diretorio, k_threshold);
+        return 0;
+    }
+
+    //reducao contra a forca bruta: ./benchmark --reducao-verificar [instancias] [-s semente] [-k K]
+    if (argc > 1 && string(argv[1]) == "--reducao-verificar") {
+        int num_instancias = 300;
+        uint64_t semente = SEMENTE;
+        int proximo = 2;
+        if (argc > 2 && std::isdigit((unsigned char)argv[2][0])) {
+            num_instancias = std::max(1, atoi(argv[2]));
+            proximo = 3;
+        }
+        int k_verificacao = -1; //alterna 0, 1 e 2
+        while (argc > proximo + 1 && (string(argv[proximo]) == "-s" || string(argv[proximo]) == "-k")) {
+            if (string(argv[proximo]) == "-s") semente = std::strtoull(argv[proximo + 1], nullptr, 10);
+            else k_verificacao = atoi(argv[proximo + 1]);
+            proximo += 2;
+        }
+        return verificar_reducao(num_instancias, semente, k_verificacao) == 0 ? 0 : 1;
+    }
+
+    //motores geracional e assincrono: ./benchmark --assincrono [segundos] [-t threads] [-s sementes] [instancias...]
+    if (argc > 1 && string(argv[1]) == "--assincrono") {
+        double tempo_limite_s = 10.0;
+        int num_threads = std::max(1u, std::thread::hardware_concurrency());
+        int num_sementes = 3;
+        int proximo = 2;
+        if (argc > 2 && std::isdigit((unsigned char)argv[2][0])) {
+            tempo_limite_s = atof(argv[2]);
+            proximo = 3;
+        }
+        while (argc > proximo + 1 && (string(argv[proximo]) == "-t" || string(argv[proximo]) == "-s")) {
+            int valor = std::max(1, atoi(argv[proximo + 1]));
+            if (string(argv[proximo]) == "-t") num_threads = valor;
+            else num_sementes = valor;
+            proximo += 2;
+        }
+        vector<string> arquivos(argv + proximo, argv + argc);
+        if (arquivos.empty()) {
+            arquivos = {"instancias//scp41-3.txt", "instancias//scpclr10-3.txt", "instancias//scpnrh1-3.txt"};
+        }
+        comparar_motores(arquivos, k_threshold, tempo_limite_s, num_threads, num_sementes);
+        return 0;
+    }
+
+    //todas as variantes do decodificador contra a referencia: ./benchmark --variantes [-k K] [instancias...]
+    if (argc > 1 && string(argv[1]) == "--variantes") {
+        int proximo = 2;
+        if (argc > proximo + 1 && string(argv[proximo]) == "-k") {
+            k_threshold = atoi(argv[proximo + 1]);
+            proximo += 2;
+        }
+        vector<string> arquivos(argv + proximo, argv + argc);
+        if (arquivos.empty()) {
+            arquivos = {"instancias//scp41-3.txt", "instancias//scpa1-3.txt", "instancias//scpclr10-3.txt",
+                        "instancias//scpcyc06-3.txt", "instancias//scpnrh1-3.txt"};
+        }
+        return verificar_variantes(arquivos, k_threshold) == 0 ? 0 : 1;
+    }
+
+    //suite completa: ./benchmark --suite [repeticoes] [-k K] [instancias...]
+    if (argc > 1 && string(argv[1]) == "--suite") {
+        int proximo = 2;
+        int repeticoes = REPETICOES_PADRAO;
+        if (argc > 2 && std::isdigit((unsigned char)argv[2][0])) {
+            repeticoes = std::max(1, atoi(argv[2]));
+            proximo = 3;
+        }
+        if (argc > proximo + 1 && string(argv[proximo]) == "-k") {
+            k_threshold = atoi(argv[proximo + 1]);
+            proximo += 2;
+        }
+        vector<string> arquivos(argv + proximo, argv + argc);
+        if (arquivos.empty()) {
+            arquivos = {"instancias//scp41-3.txt", "instancias//scpa1-3.txt", "instancias//scpclr10-3.txt",
+                        "instancias//scpcyc06-3.txt", "instancias//scpnrh1-3.txt"};
+        }
+        executar_suite(arquivos, k_threshold, repeticoes);
+        return 0;
+    }
+
+    //vazao do decodificador: ./benchmark [-k K] [--variante <nenhum|esparsos|densos>,<32|16>,<real|inteiro>] [instancias...]
+    //(sem --variante, cada instancia usa a variante escolhida por especializar_instancia)
+    int proximo = 1;
+    bool forcar_variante = false;
+    VarianteDecodificador variante;
+    while (argc > proximo + 1 && (string(argv[proximo]) == "-k" || string(argv[proximo]) == "--variante")) {
+        if (string(argv[proximo]) == "-k") {
+            k_threshold = atoi(argv[proximo + 1]);
+        } else if (!interpretar_variante(argv[proximo + 1], variante)) {
+            cerr << "Variante invalida: " << argv[proximo + 1] << " (use <nenhum|esparsos|densos>,<32|16>,<real|inteiro>)" << endl;
+            return 1;
+        } else {
+            forcar_variante = true;
+        }
+        proximo += 2;
+    }
+    vector<string> arquivos(argv + proximo, argv + argc);
+    if (arquivos.empty()) {
+        arquivos = {"instancias//scp41-3.txt", "instancias//scpclr10-3.txt", "instancias//scpnrh1-3.txt"};
+    }
+    int max_threads = std::max(1u, std::thread::hardware_concurrency()); //limite do teste de escalabilidade
+
+    for (const string& nome_arquivo : arquivos) {
+        SCPCSInstance inst;
+        if (!ler_instancia_scpcs(nome_arquivo, inst, k_threshold)) {
+            continue;
+        }
+        calcular_custos_conflito(inst, k_threshold);
+        if (forcar_variante && !especializar_instancia(inst, variante)) {
+            cerr << nome_arquivo << ": variante nao suportada (" << descrever_variante(variante) << ")" << endl;
+            continue;
+        }
+        cout << nome_arquivo << " [decodificador]: " << descrever_variante(inst.variante) << endl;
+
+        //A/B entre as duas estrategias do decodificador (as somas de custos devem coincidir)
+        double vazao_varredura = medir_decodificacoes_por_segundo(inst, DECODIFICADOR_VARREDURA);
+        cout << nome_arquivo << " [varredura]: " << vazao_varredura << " decodificacoes/s" << endl;
+        double vazao_fila = medir_decodificacoes_por_segundo(inst, DECODIFICADOR_FILA_PRIORIDADE);
+        cout << nome_arquivo << " [fila de prioridade]: " << vazao_fila << " decodificacoes/s" << endl;
+
+        cout << nome_arquivo << " [escalabilidade forte, fila de prioridade]:" << endl;
+        medir_escalabilidade(inst, DECODIFICADOR_FILA_PRIORIDADE, max_threads);
+        cout << endl;
+    }
+    return 0;
+}
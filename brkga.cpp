@@ -1,204 +1,474 @@
-#include "scp_cs_data.hpp"
-#include "decodificador.hpp"
-#include <iostream>
-#include <string>
-#include <cstdlib>
-#include <random>
+#include "brkga.hpp"
+#include "gerador_aleatorio.hpp"
+#include <vector>
 #include <algorithm>
-#include <future>
+#include <atomic>
 #include <chrono>
+#include <cstring>
+#include <limits>
+#include <numeric>
 
 #define MIN_VALUE 0.01 //valor minimo para um gene
 #define MAX_VALUE 0.99 //valor maximo para um gene
 #define RHO 0.7 //probabilidade de um gene de individuo de elute ser escolhido
+#define ID_FLUXO_REINICIO (~0ULL) //fluxo das sementes dos reinicios (os fluxos das geracoes nunca chegam a ele)
 
 using namespace std;
 
-struct Cromossomo{
-    std::vector<float> genes;
-    double fitness = 0;
-};
-
-static std::mt19937_64& get_rng() {
-    static std::mt19937_64 rng(std::random_device{}());
-    return rng;
+//identificador do fluxo aleatorio do individuo "indice" da geracao "geracao" (geracao 0 = populacao inicial)
+//cada individuo gerado tem o seu proprio fluxo, entao o resultado nao depende da thread que o gera
+static uint64_t id_fluxo(int geracao, int indice, int tamanho_populacao) {
+    return (uint64_t)geracao * tamanho_populacao + indice;
 }
 
-//Gerar número aleatório entre MIN_VALUE e MAX_VALUE
-float gerar_numero_aleatorio(){
-    std::uniform_real_distribution<double> dist(MIN_VALUE, MAX_VALUE);
-    return dist(get_rng());
+//gera um cromossomo aleatorio (populacao inicial e mutantes): o gene j é a posicao j do fluxo
+void gerar_cromossomo_aleatorio(float* genes, int num_genes, const FluxoAleatorio& fluxo) {
+    for(int j = 0; j < num_genes; j++){
+        genes[j] = fluxo.uniforme(j, MIN_VALUE, MAX_VALUE);
+    }
 }
 
-int gerar_indice_aleatorio(int max_exclusive) { //Gera índice entre 0 e max_exclusive-1
-    std::uniform_int_distribution<int> dist_int(0, max_exclusive - 1);
-    return dist_int(get_rng());
+//crossover parametrizado: cada gene vem do pai da elite com probabilidade RHO
+//(o laco é uma selecao sem desvios, que o compilador consegue vetorizar)
+void gerar_filho(float* filho, const float* pai1, const float* pai2, int num_genes, const FluxoAleatorio& fluxo) {
+    for(int j = 0; j < num_genes; j++){
+        float probabilidade = fluxo.uniforme(j);
+        filho[j] = (probabilidade <= (float)RHO) ? pai1[j] : pai2[j];
+    }
 }
 
-//gera uma populacao inicial de cromossomos de maneira aleatoria
-vector<Cromossomo> gerar_populacao_inicial(SCPCSInstance instancia, int tamanho_populacao){
-    vector<Cromossomo> populacao;
+//instante inicial de uma medicao do rastreamento (sem leitura do relogio com o rastreamento desligado)
+static std::chrono::steady_clock::time_point marca_rastreamento() {
+    if constexpr (RASTREAMENTO_ATIVO) return std::chrono::steady_clock::now();
+    return {};
+}
 
-    for(int contador_populacao = 0; contador_populacao < tamanho_populacao; contador_populacao++){
-        Cromossomo novo_cromossomo;
-        novo_cromossomo.genes.resize(instancia.num_subconjuntos);
+static double segundos_desde(std::chrono::steady_clock::time_point inicio) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
 
-        for(int gene_idx = 0; gene_idx < instancia.num_subconjuntos; gene_idx++){
-            novo_cromossomo.genes[gene_idx] = gerar_numero_aleatorio();
+//avalia os individuos novos da populacao no pool de threads persistente
+//cada tarefa le os genes do cromossomo por referencia e escreve o fitness na propria posicao,
+//usando a area de trabalho do decodificador da thread que a executa (contextos[id_thread])
+//(o cache, se ativo, é compartilhado por todas as threads; medicoes[id_thread] recebe o rastreamento da thread)
+void aplicar_fitness_paralela(Populacao& populacao, int indice_inicio_novos, const SCPCSInstance& instancia,
+                              ModoDecodificador modo_decodificador, PoolThreads& pool,
+                              vector<ContextoDecodificador>& contextos, CacheFitness* cache, vector<MedicoesThread>& medicoes) {
+    int num_novos = populacao.tamanho - indice_inicio_novos; //Calcular fitness apenas dos novos
+
+    pool.executar(num_novos, [&](int i, int id_thread) {
+        int indice = indice_inicio_novos + i;
+        ContextoDecodificador& ctx = contextos[id_thread];
+        auto inicio = marca_rastreamento();
+        populacao.fitness[indice] = decodificar(populacao.cromossomo(indice), instancia, ctx, modo_decodificador, cache);
+        if constexpr (RASTREAMENTO_ATIVO) {
+            MedicoesThread& medicao = medicoes[id_thread];
+            medicao.tempo_avaliacao_s += segundos_desde(inicio);
+            if (!ctx.acerto_cache) {
+                medicao.iteracoes_gulosas += (long long)ctx.selecionados.size(); //uma escolha por iteracao do laco guloso
+                medicao.usos_fora_lcr += ctx.usou_fora_lcr;
+            }
         }
+    });
+}
+
+//acumula em acumulado_s o tempo de execucao de uma etapa da geracao
+template <typename Etapa>
+static void cronometrar(double& acumulado_s, Etapa etapa) {
+    auto inicio = std::chrono::steady_clock::now();
+    etapa();
+    acumulado_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
 
-        populacao.push_back(novo_cromossomo);
+//recodifica os genes para que o decodificador escolha primeiro a solucao refinada: os subconjuntos
+//da solucao vao para a metade superior do intervalo dos genes e os demais para a metade inferior,
+//mantendo a ordem relativa dentro de cada grupo (os subconjuntos redundantes removidos ficam com chaves baixas)
+static void recodificar_genes(float* genes, int num_genes, const BuscaLocal& busca) {
+    const float minimo = (float)MIN_VALUE;
+    const float meio = (float)((MIN_VALUE + MAX_VALUE) / 2);
+    for (int j = 0; j < num_genes; j++) {
+        float deslocado = minimo + (genes[j] - minimo) * 0.5f;
+        genes[j] = busca.selecionado(j) ? deslocado + (meio - minimo) : deslocado;
     }
-    return populacao;
 }
 
-void aplicar_fitness_paralela(vector<Cromossomo>& populacao, int indice_inicio_novos, const SCPCSInstance& instancia) {
-    //Cada future representa um thread que está calculando um fitness
-    std::vector<std::future<double>> futuros_fitness;
+MotorBRKGA::MotorBRKGA(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros, PoolThreads& pool, int ilha)
+    : instancia(instancia), parametros(parametros), pool(pool), ilha(ilha),
+      atual(parametros.tamanho_populacao, instancia.num_subconjuntos),
+      proxima(parametros.tamanho_populacao, instancia.num_subconjuntos),
+      contextos(pool.num_threads()), buscas(pool.num_threads()), melhores_refinadas(pool.num_threads()),
+      cache(parametros.tamanho_cache_fitness), medicoes(pool.num_threads()), inicio(std::chrono::steady_clock::now()) {} //inicio contagem do tempo
 
-    int num_novos = populacao.size() - indice_inicio_novos; //Calcular fitness apenas dos novos
-    futuros_fitness.reserve(num_novos); //Reserva espaço
-    //lançar as tarefas em paralelo
-    for (size_t i = indice_inicio_novos; i < populacao.size(); ++i) {
-        //std::async agenda a função 'decodificar' para rodar em um thread separado
-        futuros_fitness.push_back(
-            std::async(
-                std::launch::async, //força a execução em um novo thread
-                decodificar,        //a funcao a ser chamada no thread
-                populacao[i].genes,   //genes é copiado
-                std::cref(instancia), //instancia é passada por referência constante
-                nullptr
-            )
-        );
+double MotorBRKGA::segundos_desde_inicio() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+//com mais de um criterio atingido na mesma geracao, o alvo tem prioridade, depois o numero de geracoes
+bool MotorBRKGA::motivo_parada(MotivoParada* motivo) const {
+    MotivoParada atingido;
+    if (parametros.parar_no_alvo && resultado.tempo_alvo_s >= 0) {
+        atingido = PARADA_ALVO;
+    } else if (cont_geracao >= parametros.num_geracoes) {
+        atingido = PARADA_GERACOES;
+    } else if (parametros.max_geracoes_sem_melhoria > 0 &&
+               cont_geracao - resultado.geracao_melhor >= parametros.max_geracoes_sem_melhoria) {
+        atingido = PARADA_ESTAGNACAO;
+    } else if (parametros.tempo_limite_s > 0 && segundos_desde_inicio() >= parametros.tempo_limite_s) {
+        atingido = PARADA_TEMPO;
+    } else {
+        return false;
     }
-    //o programa principal espera cada thread terminar
-    int fut_idx = 0; //indice para o vetor de futuros
-    for (size_t i = indice_inicio_novos; i < populacao.size(); ++i) {
-        //.get() espera o thread [fut_idx] terminar e retorna o 'double' (fitness)
-        populacao[i].fitness = futuros_fitness[fut_idx].get();
-        fut_idx++;
+    if (motivo != nullptr) *motivo = atingido;
+    return true;
+}
+
+//registra o instante da melhor solucao e do alvo (o melhor so muda depois de cada ordenacao da populacao)
+void MotorBRKGA::registrar_melhor() {
+    double fitness_geracao = melhor_fitness();
+    if (fitness_geracao >= melhor) return;
+    melhor = fitness_geracao;
+    resultado.tempo_melhor_s = segundos_desde_inicio();
+    resultado.geracao_melhor = cont_geracao;
+    resultado.convergencia.push_back({ilha, cont_geracao, resultado.tempo_melhor_s, melhor});
+    if (resultado.tempo_alvo_s < 0 && parametros.custo_alvo >= 0 && melhor <= parametros.custo_alvo) {
+        resultado.tempo_alvo_s = resultado.tempo_melhor_s;
     }
 }
 
-double brkga(SCPCSInstance& instancia, int tamanho_elite, int tamanho_populacao, int num_geracoes, float percentual_mutantes){
-    vector<Cromossomo> populacao = gerar_populacao_inicial(instancia, tamanho_populacao);
+void MotorBRKGA::inicializar() {
+    int n = instancia.num_subconjuntos;
+    int tamanho_populacao = parametros.tamanho_populacao;
+    uint64_t semente = parametros.semente;
+    abrir_registro();
 
-    aplicar_fitness_paralela(populacao, 0, instancia);
-    std::sort(populacao.begin(), populacao.end(), [](const Cromossomo& a, const Cromossomo& b) {
-        return a.fitness < b.fitness;
+    pool.executar(tamanho_populacao, [&](int i, int) {
+        gerar_cromossomo_aleatorio(atual.genes_individuo(i), n, FluxoAleatorio(semente, id_fluxo(0, i, tamanho_populacao)));
     });
+    cronometrar(resultado.tempo_avaliacao_s, [&] {
+        aplicar_fitness_paralela(atual, 0, instancia, parametros.modo_decodificador, pool, contextos, &cache, medicoes);
+    });
+    resultado.decodificacoes += tamanho_populacao;
+    cronometrar(resultado.tempo_ordenacao_s, [&] { atual.ordenar(); });
+    registrar_melhor();
+    fechar_registro();
+}
 
-    int cont_geracao = 0;
+void MotorBRKGA::evoluir_geracao() {
+    int n = instancia.num_subconjuntos;
+    int tamanho_populacao = parametros.tamanho_populacao;
+    int tamanho_elite = parametros.tamanho_elite;
+    uint64_t semente = parametros.semente;
+    int num_mutantes = (int)(tamanho_populacao * parametros.percentual_mutantes);
+    abrir_registro();
+
+    auto inicio_reproducao = std::chrono::steady_clock::now();
+
+    //copiar elite para nova populacao (uma unica copia por individuo, ja na ordem de fitness)
+    for(int r = 0; r < tamanho_elite; r++){
+        int indice_elite = atual.ordem[r];
+        std::memcpy(proxima.genes_individuo(r), atual.cromossomo(indice_elite).begin(), n * sizeof(float));
+        proxima.fitness[r] = atual.fitness[indice_elite];
+        proxima.refinado[r] = atual.refinado[indice_elite];
+    }
 
-    auto start = std::chrono::steady_clock::now(); //inicio contagem do tempo
+    //salva o índice onde os indivíduos novos (não-elite) comecarao
+    int indice_inicio_novos = tamanho_elite;
 
-    while(cont_geracao < num_geracoes){
-        //selecionar elite
-        vector<Cromossomo> elite(populacao.begin(), populacao.begin() + tamanho_elite);
+    //determinar porcentagem de mutantes na populacao
+    int tamanho_atual = std::min(tamanho_populacao, tamanho_elite + num_mutantes);
 
-        //copiar elite para nova populacao
-        vector<Cromossomo> nova_populacao = elite;
+    //mutantes e filhos do crossover sao gerados em paralelo, cada um com o seu fluxo aleatorio
+    pool.executar(tamanho_populacao - indice_inicio_novos, [&](int k, int id_thread) {
+        int i = indice_inicio_novos + k;
+        FluxoAleatorio fluxo(semente, id_fluxo(cont_geracao + 1, i, tamanho_populacao));
+        proxima.refinado[i] = 0;
+        auto inicio_tarefa = marca_rastreamento();
 
-        //salva o índice onde os indivíduos novos (não-elite) comecarao
-        int indice_inicio_novos = nova_populacao.size();
+        if(i < tamanho_atual){
+            gerar_cromossomo_aleatorio(proxima.genes_individuo(i), n, fluxo);
+            if constexpr (RASTREAMENTO_ATIVO) medicoes[id_thread].tempo_mutantes_s += segundos_desde(inicio_tarefa);
+            return;
+        }
+        //pais escolhidos aleatoriamente (pai1 é escolhido dentro do conjunto de elite)
+        //os indices usam as posicoes n e n + 1 do fluxo, depois das usadas pelos genes
+        //os genes sao lidos diretamente da populacao atual, sem copiar os pais
+        const float* pai1 = atual.cromossomo(atual.ordem[fluxo.indice(n, tamanho_elite)]).begin();
+        const float* pai2 = atual.cromossomo(atual.ordem[tamanho_elite + fluxo.indice(n + 1, tamanho_populacao - tamanho_elite)]).begin();
+        gerar_filho(proxima.genes_individuo(i), pai1, pai2, n, fluxo);
+        if constexpr (RASTREAMENTO_ATIVO) medicoes[id_thread].tempo_crossover_s += segundos_desde(inicio_tarefa);
+    });
+    std::swap(atual, proxima);
+    resultado.tempo_reproducao_s += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio_reproducao).count();
+
+    //chama a funcao paralela, que só avalia os novos (individuos copiados nao precisam ser re-avaliados)
+    cronometrar(resultado.tempo_avaliacao_s, [&] {
+        aplicar_fitness_paralela(atual, indice_inicio_novos, instancia, parametros.modo_decodificador, pool, contextos, &cache, medicoes);
+    });
+    resultado.decodificacoes += tamanho_populacao - indice_inicio_novos;
 
-        //determinar porcentagem de mutantes na populacao e gerá-los efetivamente
-        vector<Cromossomo> mutantes = gerar_populacao_inicial(instancia, (int)(tamanho_populacao * percentual_mutantes));
+    //ordenar a populacao em ordem crescente de fitness (somente a permutacao de indices)
+    cronometrar(resultado.tempo_ordenacao_s, [&] { atual.ordenar(); });
+    cont_geracao++;
 
-        nova_populacao.insert(nova_populacao.end(), mutantes.begin(), mutantes.end());
+    //busca local nos melhores individuos a cada intervalo_busca_local geracoes (e reordenacao, pois o fitness mudou)
+    bool usar_busca_local = parametros.busca_local_elite > 0 && parametros.intervalo_busca_local > 0;
+    if (usar_busca_local && cont_geracao % parametros.intervalo_busca_local == 0) {
+        cronometrar(resultado.tempo_busca_local_s, [&] { aplicar_busca_local_elite(); });
+        cronometrar(resultado.tempo_ordenacao_s, [&] { atual.ordenar(); });
+    }
+    registrar_melhor();
+
+    //reinicio quando a elite converge para praticamente a mesma LCR (os filhos passam a repetir os pais)
+    if (parametros.diversidade_minima > 0 && !terminou()) {
+        double diversidade = 1.0;
+        cronometrar(resultado.tempo_reproducao_s, [&] { diversidade = diversidade_elite(); });
+        if (diversidade < parametros.diversidade_minima) {
+            reiniciar_populacao();
+            registrar_melhor();
+        }
+    }
+    fechar_registro();
+}
 
-        int tamanho_atual = nova_populacao.size();
+void MotorBRKGA::abrir_registro() {
+    if constexpr (RASTREAMENTO_ATIVO) {
+        for (MedicoesThread& medicao : medicoes) medicao = MedicoesThread();
+        inicio_registro.tempo_reproducao_s = resultado.tempo_reproducao_s;
+        inicio_registro.tempo_avaliacao_s = resultado.tempo_avaliacao_s;
+        inicio_registro.tempo_ordenacao_s = resultado.tempo_ordenacao_s;
+        inicio_registro.tempo_busca_local_s = resultado.tempo_busca_local_s;
+        inicio_registro.decodificacoes = resultado.decodificacoes;
+        inicio_registro.acertos_cache = cache.acertos();
+        inicio_registro.reinicios = resultado.reinicios;
+    }
+}
 
-        //implementacao do crossover
-        for(int i = 0; i < tamanho_populacao - tamanho_atual; i++){
-            //pais escolhidos aleatoriamente (pai1 é escolhido dentro do conjunto de elite)
-            const Cromossomo pai1 = elite[gerar_indice_aleatorio(tamanho_elite)]; 
-            const Cromossomo pai2 = populacao[tamanho_elite + gerar_indice_aleatorio(tamanho_populacao - tamanho_elite)];
+//registro da geracao: diferencas dos totais do resultado desde abrir_registro e medicoes das threads
+void MotorBRKGA::fechar_registro() {
+    if constexpr (RASTREAMENTO_ATIVO) {
+        RegistroGeracao registro;
+        registro.ilha = ilha;
+        registro.geracao = cont_geracao;
+        registro.tempo_s = segundos_desde_inicio();
+        registro.melhor = melhor_fitness();
+        registro.tempo_reproducao_s = resultado.tempo_reproducao_s - inicio_registro.tempo_reproducao_s;
+        registro.tempo_avaliacao_s = resultado.tempo_avaliacao_s - inicio_registro.tempo_avaliacao_s;
+        registro.tempo_ordenacao_s = resultado.tempo_ordenacao_s - inicio_registro.tempo_ordenacao_s;
+        registro.tempo_busca_local_s = resultado.tempo_busca_local_s - inicio_registro.tempo_busca_local_s;
+        registro.decodificacoes = resultado.decodificacoes - inicio_registro.decodificacoes;
+        registro.acertos_cache = cache.acertos() - inicio_registro.acertos_cache;
+        long long feitas = registro.decodificacoes - registro.acertos_cache;
+        if (feitas > 0) registro.tempo_economizado_cache_s = registro.acertos_cache * registro.tempo_avaliacao_s / feitas;
+        registro.reinicios = resultado.reinicios - inicio_registro.reinicios;
+        for (const MedicoesThread& medicao : medicoes) {
+            registro.tempo_mutantes_s += medicao.tempo_mutantes_s;
+            registro.tempo_crossover_s += medicao.tempo_crossover_s;
+            registro.avaliacao_ocupado_s.push_back(medicao.tempo_avaliacao_s);
+            registro.iteracoes_gulosas += medicao.iteracoes_gulosas;
+            registro.usos_fora_lcr += medicao.usos_fora_lcr;
+        }
+        resultado.rastro.push_back(std::move(registro));
+    }
+}
 
-            Cromossomo filho;
-            filho.genes.resize(instancia.num_subconjuntos);
+//diversidade da elite pelo posto das chaves: a LCR de cada individuo (as tamanho_lcr maiores chaves, na ordem
+//do decodificador) é comparada com a do melhor individuo, e a distancia é a fracao da LCR fora da LCR do melhor
+//(distancia de Hamming entre os indicadores "posto < tamanho_lcr", dividida por 2 x tamanho_lcr)
+//retorna a distancia media da elite ao melhor: 0 = mesma LCR em toda a elite, 1 = LCRs disjuntas
+double MotorBRKGA::diversidade_elite() {
+    int n = atual.num_genes;
+    int tamanho_elite = std::min(parametros.tamanho_elite, atual.tamanho);
+    if (tamanho_elite < 2) return 1.0;
+    int tamanho_prefixo = std::min(n, tamanho_lcr(n));
+    indices_lcr.resize(n);
+    na_lcr_melhor.assign(n, 0);
+
+    //separa os indices das tamanho_prefixo maiores chaves (nth_element, sem ordenar)
+    auto separar_lcr = [&](int individuo) {
+        Intervalo<float> genes = atual.cromossomo(individuo);
+        std::iota(indices_lcr.begin(), indices_lcr.end(), 0);
+        if (tamanho_prefixo < n) {
+            std::nth_element(indices_lcr.begin(), indices_lcr.begin() + tamanho_prefixo, indices_lcr.end(), [&](int a, int b) {
+                return genes[a] > genes[b] || (genes[a] == genes[b] && a < b);
+            });
+        }
+    };
+    separar_lcr(atual.ordem[0]);
+    for (int i = 0; i < tamanho_prefixo; i++) na_lcr_melhor[indices_lcr[i]] = 1;
+
+    double soma_distancias = 0.0;
+    for (int r = 1; r < tamanho_elite; r++) {
+        separar_lcr(atual.ordem[r]);
+        int fora = 0;
+        for (int i = 0; i < tamanho_prefixo; i++) fora += !na_lcr_melhor[indices_lcr[i]];
+        soma_distancias += (double)fora / tamanho_prefixo;
+    }
+    return soma_distancias / (tamanho_elite - 1);
+}
 
-            for(int j = 0; j < instancia.num_subconjuntos; j++){
-                float probabilidade = gerar_numero_aleatorio();
+//regera todos os individuos, menos o melhor, com cromossomos aleatorios
+//cada reinicio tem a sua propria semente, derivada da semente da execucao (o fluxo de cada individuo
+//continua sendo definido pela geracao e pela posicao, sem repetir os mutantes das geracoes seguintes)
+void MotorBRKGA::reiniciar_populacao() {
+    int n = atual.num_genes;
+    int tamanho_populacao = atual.tamanho;
+
+    //o melhor vai para a posicao 0 e os novos ocupam as posicoes 1.. (avaliadas como os individuos novos de uma geracao)
+    int indice_melhor = atual.ordem[0];
+    if (indice_melhor != 0) {
+        std::memcpy(atual.genes_individuo(0), atual.cromossomo(indice_melhor).begin(), n * sizeof(float));
+        atual.fitness[0] = atual.fitness[indice_melhor];
+        atual.refinado[0] = atual.refinado[indice_melhor];
+    }
+    uint64_t semente_reinicio = FluxoAleatorio(parametros.semente, ID_FLUXO_REINICIO).bits(resultado.reinicios);
+    cronometrar(resultado.tempo_reproducao_s, [&] {
+        pool.executar(tamanho_populacao - 1, [&](int k, int) {
+            int i = k + 1;
+            gerar_cromossomo_aleatorio(atual.genes_individuo(i), n,
+                                       FluxoAleatorio(semente_reinicio, id_fluxo(cont_geracao, i, tamanho_populacao)));
+            atual.refinado[i] = 0;
+        });
+    });
+    cronometrar(resultado.tempo_avaliacao_s, [&] {
+        aplicar_fitness_paralela(atual, 1, instancia, parametros.modo_decodificador, pool, contextos, &cache, medicoes);
+    });
+    resultado.decodificacoes += tamanho_populacao - 1;
+    cronometrar(resultado.tempo_ordenacao_s, [&] { atual.ordenar(); });
+    resultado.reinicios++;
+}
 
-                if(probabilidade <= RHO){ //se o numero aleatorio gerado é menor ou igual a rho, filho herda gene do pai da elite 
-                    filho.genes[j] = pai1.genes[j];
-                } else {
-                    filho.genes[j] = pai2.genes[j];
-                }
+//etapa de busca local: refina em paralelo os parametros.busca_local_elite melhores individuos que ainda nao
+//foram refinados, sob o orcamento de tempo da etapa e de movimentos por individuo
+//o fitness recebe o custo melhorado e, opcionalmente, os genes sao recodificados a partir da solucao refinada
+void MotorBRKGA::aplicar_busca_local_elite() {
+    OrcamentoBusca orcamento;
+    orcamento.max_movimentos = parametros.movimentos_busca_local;
+    if (parametros.tempo_busca_local_ms > 0) {
+        orcamento.prazo = std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double, std::milli>(parametros.tempo_busca_local_ms));
+    }
+    int num_refinar = std::min(parametros.busca_local_elite, atual.tamanho);
+    std::atomic<long long> num_buscas{0}, num_melhorias{0};
+
+    pool.executar(num_refinar, [&](int r, int id_thread) {
+        int i = atual.ordem[r];
+        //individuos ja refinados (elite copiada) sao pulados; com o prazo esgotado, ficam para a proxima etapa
+        if (atual.refinado[i] || std::chrono::steady_clock::now() >= orcamento.prazo) return;
+
+        ContextoDecodificador& ctx = contextos[id_thread];
+        decodificar(atual.cromossomo(i), instancia, ctx, parametros.modo_decodificador);
+        BuscaLocal& busca = buscas[id_thread];
+        busca.carregar(instancia, ctx.selecionados);
+        double custo = busca.otimizar(orcamento);
+
+        atual.refinado[i] = 1;
+        num_buscas.fetch_add(1, std::memory_order_relaxed);
+        if (custo < atual.fitness[i]) {
+            num_melhorias.fetch_add(1, std::memory_order_relaxed);
+            atual.fitness[i] = custo;
+            if (parametros.recodificar_busca_local) {
+                recodificar_genes(atual.genes_individuo(i), atual.num_genes, busca);
             }
-            nova_populacao.push_back(filho);
         }
-        populacao = nova_populacao;
+        //o fitness melhorado pode nao ser reproduzido pelo decodificador, entao a solucao é guardada
+        SolucaoRefinada& melhor_thread = melhores_refinadas[id_thread];
+        if (custo < melhor_thread.custo) {
+            melhor_thread.custo = custo;
+            melhor_thread.subconjuntos.assign(busca.selecionados_atuais().begin(), busca.selecionados_atuais().end());
+        }
+    });
+    resultado.buscas_locais += num_buscas.load();
+    resultado.buscas_com_melhoria += num_melhorias.load();
+}
+
+void MotorBRKGA::exportar_melhores(int quantidade, Migrantes& saida) const {
+    int n = atual.num_genes;
+    quantidade = std::min(quantidade, atual.tamanho);
+    saida.num_genes = n;
+    saida.genes.resize((size_t)quantidade * n);
+    saida.fitness.resize(quantidade);
+    saida.refinado.resize(quantidade);
+    for (int r = 0; r < quantidade; r++) {
+        int i = atual.ordem[r];
+        std::memcpy(saida.genes.data() + (size_t)r * n, atual.cromossomo(i).begin(), n * sizeof(float));
+        saida.fitness[r] = atual.fitness[i];
+        saida.refinado[r] = atual.refinado[i];
+    }
+}
+
+void MotorBRKGA::importar(const Migrantes& imigrantes) {
+    int n = atual.num_genes;
+    if (imigrantes.num_genes != n) return;
+
+    //o posto "vaga" é o pior individuo ainda nao substituido; a elite nunca é substituida
+    int vaga = atual.tamanho - 1;
+    bool mudou = false;
+    for (int m = 0; m < imigrantes.quantidade() && vaga >= parametros.tamanho_elite; m++) {
+        int pior = atual.ordem[vaga];
+        if (imigrantes.fitness[m] >= atual.fitness[pior]) continue;
+
+        //um imigrante igual a um individuo da populacao (mesmo fitness e mesmos genes) nao é copiado
+        bool repetido = false;
+        for (int i = 0; i < atual.tamanho && !repetido; i++) {
+            repetido = atual.fitness[i] == imigrantes.fitness[m] &&
+                       std::memcmp(atual.cromossomo(i).begin(), imigrantes.cromossomo(m).begin(), n * sizeof(float)) == 0;
+        }
+        if (repetido) continue;
 
-        //chama a funcao paralela, que só avalia os novos (individuos copiados nao precisam ser re-avaliados)
-        aplicar_fitness_paralela(populacao, indice_inicio_novos, instancia);
+        std::memcpy(atual.genes_individuo(pior), imigrantes.cromossomo(m).begin(), n * sizeof(float));
+        atual.fitness[pior] = imigrantes.fitness[m];
+        atual.refinado[pior] = imigrantes.refinado[m];
+        vaga--;
+        mudou = true;
+    }
+    if (mudou) {
+        cronometrar(resultado.tempo_ordenacao_s, [&] { atual.ordenar(); });
+        registrar_melhor();
+    }
+}
 
-        //ordenar a populacao em ordem decrescente de fitness
-        std::sort(populacao.begin(), populacao.end(), [](const Cromossomo& a, const Cromossomo& b) {
-            return a.fitness < b.fitness;
-        });
-        cont_geracao++;
+ResultadoBRKGA MotorBRKGA::finalizar() {
+    int indice_melhor = atual.ordem[0];
+    resultado.custo_antes_busca_local = atual.fitness[indice_melhor];
+
+    //solucao refinada: o melhor individuo decodificado e depois melhorado pela busca local
+    //(remocao de redundantes, trocas 1-por-1 e trocas 2-por-1)
+    decodificar(atual.cromossomo(indice_melhor), instancia, contextos[0], parametros.modo_decodificador);
+    BuscaLocal busca;
+    busca.carregar(instancia, contextos[0].selecionados);
+    resultado.custo = busca.otimizar();
+    resultado.solucao = busca.solucao();
+
+    //a melhor solucao da etapa de busca local pode ser melhor que a do melhor individuo decodificado
+    for (const SolucaoRefinada& refinada : melhores_refinadas) {
+        if (refinada.custo < resultado.custo) {
+            resultado.custo = refinada.custo;
+            resultado.solucao = std::set<int>(refinada.subconjuntos.begin(), refinada.subconjuntos.end());
+        }
     }
-    double melhor_fitness_bruto = populacao[0].fitness;
-    cout << "Melhor solucao (Antes da Busca Local): " << melhor_fitness_bruto << std::endl;
-    
-    //solucao_refinada é criado para receber o conjunto solucao final
-    std::set<int> solucao_refinada;
-    decodificar(populacao[0].genes, instancia, &solucao_refinada);
 
-    double custo_final = melhor_fitness_bruto;
-    solucao_refinada = busca_local_remocao(solucao_refinada, instancia, custo_final);
+    //o tempo economizado é estimado pelo tempo medio das decodificacoes que nao vieram do cache
+    resultado.acertos_cache = cache.acertos();
+    long long feitas = resultado.decodificacoes - resultado.acertos_cache;
+    if (feitas > 0) resultado.tempo_economizado_cache_s = resultado.acertos_cache * resultado.tempo_avaliacao_s / feitas;
 
-    cout << "Melhor solucao (Pos Busca Local): " << custo_final << std::endl;
+    resultado.geracoes = cont_geracao;
+    if (!motivo_parada(&resultado.motivo_parada)) resultado.motivo_parada = PARADA_EXTERNA;
 
     //contagem tempo
-    auto end = std::chrono::steady_clock::now();
-    auto elapsed = end - start;
-    cout << "Tempo total de execucao: "
-            << elapsed/std::chrono::seconds(1)
-            << " s" << std::endl;
-
-    cout << "Melhor solucao encontrada é composta pelos subconjuntos: " << endl;
-    for(auto elemento : solucao_refinada)
-        cout << elemento + 1 << " ";
-    cout << endl << endl;
-
-    return custo_final; //custo refinado pela busca local
-}
-
-int main(){
-    SCPCSInstance inst;
-
-    vector<Cromossomo> populacao;
-
-    string nome_arquivo = "instancias//scpclr10-3.txt"; //nome do arquivo que contem a instancia
-    int k_threshold = 1; //valor k (tolerancia de elementos em comum)
-    int tamanho_populacao = 140; //numero de individuos da populacao
-    int tamanho_elite = 28; //numero de individuos da elite
-    int num_testes = 5; //numero de vezes que a instancia sera executada com a configuracao determinada
-    int num_geracoes = 500; //numero de geracoes que cada execução terá
-    float percentual_mutantes = 0.2; //percentual de mutantes na populacao
-
-    ler_instancia_scpcs(nome_arquivo, inst, k_threshold);
-    calcular_custos_conflito(inst, k_threshold);
-
-    cout << "Teste" << endl;
-    cout << "instancia: " << nome_arquivo << endl;
-    cout << "populacao: " << tamanho_populacao << endl;
-    cout << "tamanho elite: " << tamanho_elite << endl;
-    cout << "numero de geracoes: " << num_geracoes << endl;
-    cout << "k: " << k_threshold << endl;
-
-    double melhor_solucao = std::numeric_limits<int>::max(), media = 0.0, resultado = 0.0; 
-    for(int i = 0; i < num_testes; i++){
-        resultado = brkga(inst, tamanho_elite, tamanho_populacao, num_geracoes, percentual_mutantes);
-        media += resultado;
-        if(resultado < melhor_solucao)
-            melhor_solucao = resultado;
-    }
-    cout << "Melhor solucao encontrada entre todas as execucoes: " << melhor_solucao << endl;
-    cout << "Media de todas as solucoes encontradas: " << media / num_testes << endl;
-
-    system("pause");
+    resultado.tempo_s = segundos_desde_inicio();
+    if (resultado.tempo_alvo_s < 0 && parametros.custo_alvo >= 0 && resultado.custo <= parametros.custo_alvo) {
+        resultado.tempo_alvo_s = resultado.tempo_s; //alvo atingido somente com a busca local final
+    }
+    return resultado;
+}
+
+ResultadoBRKGA brkga(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros, PoolThreads& pool){
+    MotorBRKGA motor(instancia, parametros, pool);
+    motor.inicializar();
+    while(!motor.terminou()){
+        motor.evoluir_geracao();
+    }
+    return motor.finalizar();
 }
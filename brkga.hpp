@@ -0,0 +1,218 @@
+#ifndef BRKGA_HPP
+#define BRKGA_HPP
+
+#include "scp_cs_data.hpp"
+#include "decodificador.hpp"
+#include "busca_local.hpp"
+#include "pool_threads.hpp"
+#include "rastreamento.hpp"
+#include "gerador_aleatorio.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <set>
+#include <vector>
+
+// Parametros de uma execucao do BRKGA
+struct ParametrosBRKGA {
+    int tamanho_populacao = 140; //numero de individuos da populacao
+    int tamanho_elite = 28; //numero de individuos da elite
+    int num_geracoes = 500; //numero de geracoes que cada execucao tera
+    float percentual_mutantes = 0.2f; //percentual de mutantes na populacao
+    ModoDecodificador modo_decodificador = DECODIFICADOR_VARREDURA; //ou DECODIFICADOR_FILA_PRIORIDADE (mesmos resultados)
+    uint64_t semente = 0; //semente da execucao (define todos os numeros aleatorios)
+    double custo_alvo = -1.0; //custo usado no tempo-ate-o-alvo (< 0 desativa a medicao)
+
+    //etapa de busca local nos melhores individuos durante a evolucao
+    int busca_local_elite = 0; //quantos dos melhores individuos sao refinados (0 = etapa desativada)
+    int intervalo_busca_local = 1; //a etapa roda a cada intervalo_busca_local geracoes
+    double tempo_busca_local_ms = 0.0; //orcamento de tempo de cada etapa, para todos os individuos (0 = sem limite)
+    long long movimentos_busca_local = 0; //orcamento de movimentos de cada individuo (0 = sem limite)
+    bool recodificar_busca_local = false; //reescreve os genes para que a solucao refinada tenha as maiores chaves
+
+    int tamanho_cache_fitness = 1 << 16; //entradas do cache de fitness indexado pela LCR (0 = desativado)
+
+    //criterios de parada adicionais ao numero de geracoes (a execucao para no primeiro atingido)
+    double tempo_limite_s = 0.0; //tempo de relogio desde o inicio da execucao (0 = sem limite)
+    bool parar_no_alvo = false; //para quando o custo_alvo for atingido
+    int max_geracoes_sem_melhoria = 0; //geracoes seguidas sem melhorar o melhor fitness (0 = sem limite)
+
+    //reinicio: quando a diversidade da elite fica abaixo do minimo, a populacao é regerada mantendo o melhor individuo
+    double diversidade_minima = 0.0; //entre 0 (elite identica) e 1 (LCRs disjuntas); 0 = sem reinicio
+};
+
+// Motivo do fim da evolucao
+enum MotivoParada {
+    PARADA_GERACOES,    //num_geracoes
+    PARADA_TEMPO,       //tempo_limite_s
+    PARADA_ALVO,        //custo_alvo atingido com parar_no_alvo
+    PARADA_ESTAGNACAO,  //max_geracoes_sem_melhoria
+    PARADA_EXTERNA      //interrompida por quem conduz o motor (ex: fim da execucao distribuida)
+};
+
+// Ponto da curva de convergencia: registrado sempre que o melhor fitness de uma populacao melhora
+struct PontoConvergencia {
+    int ilha = 0; //populacao que melhorou (0 no BRKGA com uma unica populacao)
+    int geracao = 0;
+    double tempo_s = 0.0;
+    double melhor = 0.0;
+};
+
+// Resultado de uma execucao do BRKGA
+struct ResultadoBRKGA {
+    double custo_antes_busca_local = 0.0; //fitness do melhor individuo da ultima geracao
+    double custo = 0.0; //custo refinado pela busca local
+    std::set<int> solucao; //subconjuntos da solucao refinada (indices a partir de 0)
+    double tempo_s = 0.0; //tempo total da execucao, incluindo a populacao inicial e a busca local
+    double tempo_melhor_s = 0.0; //instante em que o melhor individuo foi encontrado
+    int geracao_melhor = 0; //geracao em que o melhor individuo foi encontrado (0 = populacao inicial)
+    double tempo_alvo_s = -1.0; //instante em que o custo alvo foi atingido (-1 = nao atingido)
+    int geracoes = 0; //geracoes executadas
+    MotivoParada motivo_parada = PARADA_GERACOES;
+    int reinicios = 0; //reinicios da populacao por falta de diversidade
+
+    //tempo acumulado (em segundos) de cada etapa das geracoes
+    double tempo_reproducao_s = 0.0; //elite, mutantes e crossover
+    double tempo_avaliacao_s = 0.0; //decodificacao dos individuos novos
+    double tempo_ordenacao_s = 0.0;
+    double tempo_busca_local_s = 0.0; //etapa de busca local na elite
+    long long buscas_locais = 0; //individuos refinados pela etapa de busca local
+    long long buscas_com_melhoria = 0; //refinamentos que reduziram o custo
+
+    //cache de fitness: decodificacoes evitadas e o tempo estimado que elas teriam custado
+    long long decodificacoes = 0; //individuos avaliados (com ou sem o cache)
+    long long acertos_cache = 0;
+    double tempo_economizado_cache_s = 0.0; //acertos x tempo medio de avaliacao das decodificacoes feitas
+
+    std::vector<PontoConvergencia> convergencia;
+    std::vector<RegistroGeracao> rastro; //um registro por geracao (vazio sem BRKGA_RASTREAMENTO)
+};
+
+// Populacao armazenada em uma unica matriz contigua tamanho x num_genes:
+// os genes do individuo i ocupam genes[i * num_genes .. (i + 1) * num_genes)
+// o brkga mantem duas populacoes (atual e proxima) e apenas troca os buffers a cada geracao
+struct Populacao {
+    int tamanho = 0;
+    int num_genes = 0;
+    std::vector<float> genes;
+    std::vector<double> fitness;
+    std::vector<int> ordem; //ordem[r] é o indice do individuo de posto r (ordem crescente de fitness)
+    std::vector<char> refinado; //refinado[i] != 0 se o individuo i ja passou pela etapa de busca local
+
+    Populacao(int tamanho_populacao, int n)
+        : tamanho(tamanho_populacao), num_genes(n),
+          genes((size_t)tamanho_populacao * n), fitness(tamanho_populacao, 0.0), ordem(tamanho_populacao),
+          refinado(tamanho_populacao, 0) {}
+
+    float* genes_individuo(int i) { return genes.data() + (size_t)i * num_genes; }
+    Intervalo<float> cromossomo(int i) const {
+        const float* inicio = genes.data() + (size_t)i * num_genes;
+        return {inicio, inicio + num_genes};
+    }
+
+    //ordena uma permutacao de indices por fitness (os genes nao sao movidos)
+    void ordenar() {
+        std::iota(ordem.begin(), ordem.end(), 0);
+        std::sort(ordem.begin(), ordem.end(), [this](int a, int b) { return fitness[a] < fitness[b]; });
+    }
+};
+
+// Cromossomos trocados entre populacoes (genes contiguos, na ordem crescente de fitness)
+struct Migrantes {
+    int num_genes = 0;
+    std::vector<float> genes;      //quantidade() x num_genes
+    std::vector<double> fitness;
+    std::vector<char> refinado;
+
+    int quantidade() const { return (int)fitness.size(); }
+    Intervalo<float> cromossomo(int i) const {
+        const float* inicio = genes.data() + (size_t)i * num_genes;
+        return {inicio, inicio + num_genes};
+    }
+};
+
+// Melhor solucao encontrada pela etapa de busca local em uma thread
+struct SolucaoRefinada {
+    double custo = std::numeric_limits<double>::max();
+    std::vector<int> subconjuntos;
+};
+
+// Estado de uma execucao do BRKGA geracional, avancado uma geracao por chamada
+// (permite intercalar as geracoes com a troca de migrantes entre populacoes)
+class MotorBRKGA {
+public:
+    //a instancia e o pool devem existir enquanto o motor existir; ilha identifica a populacao nas curvas
+    MotorBRKGA(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros, PoolThreads& pool, int ilha = 0);
+
+    //gera e avalia a populacao inicial (geracao 0)
+    void inicializar();
+
+    //reproducao, avaliacao, ordenacao e, quando for a vez, a etapa de busca local
+    void evoluir_geracao();
+
+    bool terminou() const { return motivo_parada(nullptr); }
+    int geracao() const { return cont_geracao; }
+    double melhor_fitness() const { return atual.fitness[atual.ordem[0]]; }
+
+    //copia os "quantidade" melhores individuos para saida (reaproveitando a memoria de saida)
+    void exportar_melhores(int quantidade, Migrantes& saida) const;
+
+    //substitui os piores individuos (fora da elite) pelos imigrantes que forem melhores que eles
+    void importar(const Migrantes& imigrantes);
+
+    //busca local no melhor individuo e montagem do resultado
+    ResultadoBRKGA finalizar();
+
+private:
+    double segundos_desde_inicio() const;
+    bool motivo_parada(MotivoParada* motivo) const; //true (e o motivo) se algum criterio de parada foi atingido
+    void registrar_melhor();
+    void aplicar_busca_local_elite();
+    double diversidade_elite();
+    void reiniciar_populacao();
+    void abrir_registro(); //rastreamento: inicio e fim da medicao de uma geracao
+    void fechar_registro();
+
+    const SCPCSInstance& instancia;
+    ParametrosBRKGA parametros;
+    PoolThreads& pool;
+    int ilha;
+
+    //duas populacoes pre-alocadas: a geracao seguinte é montada em "proxima" a partir de "atual"
+    //e depois os buffers sao trocados, sem alocar memoria durante as geracoes
+    Populacao atual;
+    Populacao proxima;
+
+    //uma area de trabalho do decodificador e da busca local por thread do pool, reaproveitadas em todas as geracoes
+    std::vector<ContextoDecodificador> contextos;
+    std::vector<BuscaLocal> buscas;
+    std::vector<SolucaoRefinada> melhores_refinadas;
+    CacheFitness cache;
+
+    //rastreamento: medicoes de cada thread na geracao corrente e totais do resultado no inicio dela
+    std::vector<MedicoesThread> medicoes;
+    RegistroGeracao inicio_registro;
+
+    //medida de diversidade: LCR de cada individuo da elite comparada com a do melhor
+    std::vector<int> indices_lcr;
+    std::vector<char> na_lcr_melhor;
+
+    ResultadoBRKGA resultado;
+    std::chrono::steady_clock::time_point inicio;
+    int cont_geracao = 0;
+    double melhor = std::numeric_limits<double>::max(); //melhor fitness ja registrado
+};
+
+// Geracao dos individuos, compartilhada pelos motores: cromossomo aleatorio (populacao inicial e mutantes),
+// com o gene j na posicao j do fluxo, e crossover parametrizado, em que cada gene vem do pai da elite
+// com probabilidade RHO (as posicoes do fluxo a partir de num_genes ficam livres para a escolha dos pais)
+void gerar_cromossomo_aleatorio(float* genes, int num_genes, const FluxoAleatorio& fluxo);
+void gerar_filho(float* filho, const float* pai1, const float* pai2, int num_genes, const FluxoAleatorio& fluxo);
+
+// Executa o BRKGA na instancia (somente leitura, pode ser compartilhada entre execucoes simultaneas),
+// avaliando o fitness no pool de threads recebido
+ResultadoBRKGA brkga(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros, PoolThreads& pool);
+
+#endif // BRKGA_HPP
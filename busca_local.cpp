@@ -0,0 +1,309 @@
+#include "busca_local.hpp"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+#define EPSILON 1e-9 //melhoria minima para aceitar um movimento
+
+void BuscaLocal::carregar(const SCPCSInstance& inst, Intervalo<int> solucao) {
+    instancia = &inst;
+    int m = inst.num_elementos;
+    int n = inst.num_subconjuntos;
+
+    //os vetores so sao realocados quando a instancia é maior que a anterior
+    cobertura.assign(m, 0);
+    soma_conflitos.assign(n, 0.0);
+    na_solucao.assign(n, 0);
+    posicao.resize(n);
+    selecionados.clear();
+    if ((int)marca_saida.size() != m || (int)visto.size() != n) {
+        marca_saida.assign(m, 0);
+        marca_entrada.assign(m, 0);
+        visto.assign(n, 0);
+        rotulo = 0;
+    }
+
+    custo_atual = 0.0;
+    movimentos = 0;
+    orcamento = OrcamentoBusca();
+    for (int j : solucao) {
+        inserir(j);
+    }
+}
+
+void BuscaLocal::inserir(int j) {
+    const SCPCSInstance& inst = *instancia;
+    custo_atual += ganho_remocao(j);
+    na_solucao[j] = 1;
+    posicao[j] = (int)selecionados.size();
+    selecionados.push_back(j);
+
+    for (int i : inst.matriz_incidencia[j]) {
+        cobertura[i]++;
+    }
+    const GrafoConflitos& conflitos = inst.conflitos;
+    for (int p = conflitos.inicio[j]; p < conflitos.inicio[j + 1]; ++p) {
+        soma_conflitos[conflitos.vizinhos[p]] += conflitos.penalidades[p];
+    }
+}
+
+void BuscaLocal::remover(int j) {
+    const SCPCSInstance& inst = *instancia;
+    custo_atual -= ganho_remocao(j);
+    na_solucao[j] = 0;
+    //remocao O(1) da lista: o ultimo selecionado ocupa a posicao de j
+    int ultimo = selecionados.back();
+    selecionados[posicao[j]] = ultimo;
+    posicao[ultimo] = posicao[j];
+    selecionados.pop_back();
+
+    for (int i : inst.matriz_incidencia[j]) {
+        cobertura[i]--;
+    }
+    const GrafoConflitos& conflitos = inst.conflitos;
+    for (int p = conflitos.inicio[j]; p < conflitos.inicio[j + 1]; ++p) {
+        soma_conflitos[conflitos.vizinhos[p]] -= conflitos.penalidades[p];
+    }
+}
+
+bool BuscaLocal::esgotado() const {
+    if (orcamento.max_movimentos > 0 && movimentos >= orcamento.max_movimentos) return true;
+    return orcamento.prazo != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= orcamento.prazo;
+}
+
+int BuscaLocal::marcar_saida(int j) {
+    //cada subconjunto que sai usa no maximo 1 + n rotulos (um por candidato a entrar); perto do limite
+    //do contador as marcas sao zeradas e a contagem recomeca, antes de comecar a avaliar a saida de j
+    if (rotulo >= std::numeric_limits<int>::max() - instancia->num_subconjuntos - 1) {
+        std::fill(marca_saida.begin(), marca_saida.end(), 0);
+        std::fill(marca_entrada.begin(), marca_entrada.end(), 0);
+        std::fill(visto.begin(), visto.end(), 0);
+        rotulo = 0;
+    }
+    ++rotulo;
+    int exclusivos = 0;
+    for (int i : instancia->matriz_incidencia[j]) {
+        marca_saida[i] = rotulo;
+        exclusivos += (cobertura[i] == 1);
+    }
+    return exclusivos;
+}
+
+bool BuscaLocal::remover_redundantes() {
+    const SCPCSInstance& inst = *instancia;
+
+    //como remover so diminui a cobertura, um subconjunto que nao pode ser removido continua essencial
+    //depois das remocoes seguintes: uma unica passada na ordem de custo basta
+    //(desempate pela ordem crescente de indice, a mesma da solucao recebida em um set)
+    ordem.assign(selecionados.begin(), selecionados.end());
+    std::sort(ordem.begin(), ordem.end());
+    std::sort(ordem.begin(), ordem.end(), [&](int a, int b) { return inst.custos[a] > inst.custos[b]; });
+
+    bool melhorou = false;
+    for (int j : ordem) {
+        bool pode_remover = true;
+        for (int i : inst.matriz_incidencia[j]) {
+            if (cobertura[i] < 2) {
+                pode_remover = false;
+                break; //j é o unico que cobre i
+            }
+        }
+        if (pode_remover) {
+            remover(j);
+            movimentos++;
+            melhorou = true;
+        }
+    }
+    return melhorou;
+}
+
+bool BuscaLocal::aplicar_trocas() {
+    const SCPCSInstance& inst = *instancia;
+    bool melhorou = false;
+
+    ordem.assign(selecionados.begin(), selecionados.end());
+    for (int j : ordem) {
+        if (esgotado()) break;
+        if (!na_solucao[j]) continue;
+
+        //o subconjunto que entra precisa cobrir todos os elementos exclusivos de j
+        int exclusivos = marcar_saida(j);
+        if (exclusivos == 0) {
+            remover(j); //redundante
+            movimentos++;
+            melhorou = true;
+            continue;
+        }
+        int primeiro_exclusivo = -1;
+        for (int i : inst.matriz_incidencia[j]) {
+            if (cobertura[i] == 1) {
+                primeiro_exclusivo = i;
+                break;
+            }
+        }
+
+        double ganho_saida = ganho_remocao(j);
+        double melhor_delta = -EPSILON;
+        int melhor_entrada = -1;
+        for (int candidato : inst.lista_incidencia[primeiro_exclusivo]) {
+            //o custo de entrada é pelo menos c_candidato (as penalidades sao nao negativas)
+            if (na_solucao[candidato] || inst.custos[candidato] - ganho_saida >= melhor_delta) continue;
+
+            int cobertos = 0;
+            for (int i : inst.matriz_incidencia[candidato]) {
+                cobertos += (marca_saida[i] == rotulo && cobertura[i] == 1);
+            }
+            if (cobertos < exclusivos) continue;
+
+            //a penalidade com j deixa de existir, pois j sai da solucao
+            double delta = ganho_remocao(candidato) - inst.conflitos.penalidade(j, candidato) - ganho_saida;
+            if (delta < melhor_delta) {
+                melhor_delta = delta;
+                melhor_entrada = candidato;
+            }
+        }
+        if (melhor_entrada >= 0) {
+            remover(j);
+            inserir(melhor_entrada);
+            movimentos++;
+            melhorou = true;
+        }
+    }
+    return melhorou;
+}
+
+bool BuscaLocal::aplicar_trocas_2_por_1() {
+    const SCPCSInstance& inst = *instancia;
+    const GrafoConflitos& conflitos = inst.conflitos;
+    bool melhorou = false;
+
+    //limite superior do ganho de remover o segundo subconjunto (usado para descartar candidatos): os dois maiores
+    //ganhos de remocao da solucao, recalculados somente depois de um movimento aplicado
+    double maior_ganho_1 = 0.0, maior_ganho_2 = 0.0;
+    int dono_maior_ganho = -1;
+    bool recalcular_limite = true;
+
+    ordem.assign(selecionados.begin(), selecionados.end());
+    for (int a : ordem) {
+        if (esgotado()) break;
+        if (!na_solucao[a]) continue;
+
+        int exclusivos = marcar_saida(a);
+        if (exclusivos == 0) {
+            remover(a);
+            movimentos++;
+            melhorou = true;
+            recalcular_limite = true;
+            continue;
+        }
+        int rotulo_saida = rotulo;
+        int primeiro_exclusivo = -1;
+        for (int i : inst.matriz_incidencia[a]) {
+            if (cobertura[i] == 1) {
+                primeiro_exclusivo = i;
+                break;
+            }
+        }
+
+        if (recalcular_limite) {
+            maior_ganho_1 = maior_ganho_2 = 0.0;
+            dono_maior_ganho = -1;
+            for (int b : selecionados) {
+                double ganho = ganho_remocao(b);
+                if (ganho > maior_ganho_1) {
+                    maior_ganho_2 = maior_ganho_1;
+                    maior_ganho_1 = ganho;
+                    dono_maior_ganho = b;
+                } else {
+                    maior_ganho_2 = std::max(maior_ganho_2, ganho);
+                }
+            }
+            recalcular_limite = false;
+        }
+        double maior_ganho = a == dono_maior_ganho ? maior_ganho_2 : maior_ganho_1; //maior ganho entre os b != a
+
+        double ganho_a = ganho_remocao(a);
+        double melhor_delta = -EPSILON;
+        int melhor_entrada = -1, melhor_b = -1;
+        for (int entrada : inst.lista_incidencia[primeiro_exclusivo]) {
+            if (na_solucao[entrada]) continue;
+            double delta_troca = ganho_remocao(entrada) - ganho_a; //sem descontar a penalidade (a, entrada)
+            //o ganho de b é no maximo maior_ganho + pen(b, entrada) <= maior_ganho + soma_conflitos[entrada]
+            if (delta_troca - maior_ganho - soma_conflitos[entrada] >= melhor_delta) continue;
+
+            int cobertos = 0;
+            for (int i : inst.matriz_incidencia[entrada]) {
+                cobertos += (marca_saida[i] == rotulo_saida && cobertura[i] == 1);
+            }
+            if (cobertos < exclusivos) continue;
+            delta_troca -= conflitos.penalidade(a, entrada);
+
+            //depois de (-a, +entrada), so pode ficar redundante um subconjunto que cubra algum elemento de entrada
+            int rotulo_entrada = ++rotulo;
+            for (int i : inst.matriz_incidencia[entrada]) {
+                marca_entrada[i] = rotulo_entrada;
+            }
+            for (int i : inst.matriz_incidencia[entrada]) {
+                for (int b : inst.lista_incidencia[i]) {
+                    if (!na_solucao[b] || b == a || visto[b] == rotulo_entrada) continue;
+                    visto[b] = rotulo_entrada;
+
+                    bool redundante = true;
+                    for (int e : inst.matriz_incidencia[b]) {
+                        int nova_cobertura = cobertura[e] - (marca_saida[e] == rotulo_saida) + (marca_entrada[e] == rotulo_entrada);
+                        if (nova_cobertura < 2) {
+                            redundante = false;
+                            break;
+                        }
+                    }
+                    if (!redundante) continue;
+
+                    double ganho_b = ganho_remocao(b) - conflitos.penalidade(b, a) + conflitos.penalidade(b, entrada);
+                    double delta = delta_troca - ganho_b;
+                    if (delta < melhor_delta) {
+                        melhor_delta = delta;
+                        melhor_entrada = entrada;
+                        melhor_b = b;
+                    }
+                }
+            }
+        }
+        if (melhor_entrada >= 0) {
+            remover(a);
+            inserir(melhor_entrada);
+            remover(melhor_b);
+            movimentos++;
+            melhorou = true;
+            recalcular_limite = true;
+        }
+    }
+    return melhorou;
+}
+
+double BuscaLocal::otimizar(const OrcamentoBusca& limites) {
+    orcamento = limites;
+    //a remocao de redundantes é uma unica passada barata, feita mesmo com o orcamento esgotado
+    remover_redundantes();
+    bool melhorou = true;
+    while (melhorou && !esgotado()) {
+        melhorou = aplicar_trocas();
+        melhorou = aplicar_trocas_2_por_1() || melhorou;
+        if (melhorou) remover_redundantes();
+    }
+    orcamento = OrcamentoBusca();
+    return custo_atual;
+}
+
+//a busca local de remocao é aplicada somente uma vez: no melhor individuo da ultima populacao
+//ela serve para remover subconjuntos redundantes, que nao possuem, exclusivamente, nenhum elemento
+std::set<int> busca_local_remocao(std::set<int> solucao_inicial, const SCPCSInstance& instancia, double& custo_inicial) {
+    std::vector<int> solucao(solucao_inicial.begin(), solucao_inicial.end());
+    BuscaLocal busca;
+    busca.carregar(instancia, solucao);
+    double custo_carregado = busca.custo();
+    busca.remover_redundantes();
+
+    custo_inicial -= custo_carregado - busca.custo();
+    return busca.solucao();
+}
@@ -0,0 +1,83 @@
+#ifndef BUSCA_LOCAL_HPP
+#define BUSCA_LOCAL_HPP
+
+#include "scp_cs_data.hpp"
+#include <chrono>
+#include <set>
+#include <vector>
+
+// Limites de uma chamada de otimizar(): a busca para (com uma solucao viavel) quando atinge qualquer um deles
+struct OrcamentoBusca {
+    long long max_movimentos = 0; //movimentos aplicados (0 = sem limite)
+    std::chrono::steady_clock::time_point prazo = std::chrono::steady_clock::time_point::max();
+};
+
+// Busca local com avaliacao incremental (uma instancia da classe por thread, reaproveitada entre buscas)
+// o estado da solucao é mantido em dois vetores atualizados a cada movimento:
+//   cobertura[i]      = quantos subconjuntos selecionados cobrem o elemento i
+//   soma_conflitos[j] = soma das penalidades de conflito de j com os subconjuntos selecionados
+// assim, testar se j é redundante custa O(|S_j|), o ganho de remover j é c_j + soma_conflitos[j] (O(1))
+// e aplicar um movimento custa O(|S_j| + grau de j no grafo de conflitos)
+class BuscaLocal {
+public:
+    //carrega uma solucao viavel (subconjuntos distintos) e calcula o estado incremental
+    void carregar(const SCPCSInstance& instancia, Intervalo<int> solucao);
+
+    double custo() const { return custo_atual; }
+    bool selecionado(int j) const { return na_solucao[j] != 0; }
+    const std::vector<int>& selecionados_atuais() const { return selecionados; } //sem ordem
+    std::set<int> solucao() const { return std::set<int>(selecionados.begin(), selecionados.end()); }
+    long long movimentos_aplicados() const { return movimentos; }
+
+    //remove subconjuntos redundantes, do mais caro para o mais barato
+    bool remover_redundantes();
+
+    //troca 1-por-1: substitui um subconjunto selecionado por um nao selecionado que cubra
+    //todos os elementos cobertos somente por ele
+    bool aplicar_trocas();
+
+    //troca 2-por-1: substitui dois subconjuntos selecionados por um unico nao selecionado
+    bool aplicar_trocas_2_por_1();
+
+    //aplica os tres movimentos ate que nenhum deles melhore a solucao ou o orcamento acabar;
+    //retorna o custo final
+    double otimizar(const OrcamentoBusca& limites = OrcamentoBusca());
+
+private:
+    void inserir(int j);
+    void remover(int j);
+
+    //marca (com um novo rotulo) os elementos de S_j em marca_saida e retorna quantos sao cobertos somente por j
+    int marcar_saida(int j);
+
+    //true quando o orcamento da chamada atual de otimizar() acabou
+    bool esgotado() const;
+
+    //ganho de remover j da solucao
+    double ganho_remocao(int j) const { return instancia->custos[j] + soma_conflitos[j]; }
+
+    const SCPCSInstance* instancia = nullptr;
+    double custo_atual = 0.0;
+    long long movimentos = 0;
+    OrcamentoBusca orcamento;
+
+    std::vector<int> cobertura;          //por elemento
+    std::vector<double> soma_conflitos;  //por subconjunto
+    std::vector<char> na_solucao;        //por subconjunto
+    std::vector<int> selecionados;       //subconjuntos da solucao (sem ordem)
+    std::vector<int> posicao;            //posicao de cada subconjunto selecionado em selecionados
+
+    //marcas com rotulo: uma posicao vale "marcada" quando guarda o rotulo atual (evita limpar os vetores)
+    std::vector<int> marca_saida;        //por elemento: elementos do subconjunto que sai
+    std::vector<int> marca_entrada;      //por elemento: elementos do subconjunto que entra
+    std::vector<int> visto;              //por subconjunto: candidatos ja avaliados
+    int rotulo = 0;
+
+    std::vector<int> ordem;              //copia de selecionados percorrida pelos movimentos
+};
+
+// Remove os subconjuntos redundantes da solucao (do mais caro para o mais barato)
+// custo_inicial é atualizado com o custo da solucao resultante
+std::set<int> busca_local_remocao(std::set<int> solucao_inicial, const SCPCSInstance& instancia, double& custo_inicial);
+
+#endif // BUSCA_LOCAL_HPP
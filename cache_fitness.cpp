@@ -0,0 +1,32 @@
+#include "cache_fitness.hpp"
+
+using namespace std;
+
+CacheFitness::CacheFitness(int capacidade) : travas(new std::mutex[NUM_TRAVAS]) {
+    if (capacidade <= 0) return;
+    size_t tamanho = 1;
+    while (tamanho < (size_t)capacidade) tamanho <<= 1;
+    entradas.resize(tamanho);
+    mascara = tamanho - 1;
+}
+
+bool CacheFitness::buscar(const ChaveDecodificacao& chave, double& custo) {
+    num_consultas.fetch_add(1, std::memory_order_relaxed);
+    size_t posicao = chave.chave & mascara;
+    std::lock_guard<std::mutex> trava(travas[posicao % NUM_TRAVAS]);
+    const Entrada& entrada = entradas[posicao];
+    if (!entrada.ocupada || entrada.chave != chave.chave || entrada.verificacao != chave.verificacao) return false;
+    custo = entrada.custo;
+    num_acertos.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void CacheFitness::inserir(const ChaveDecodificacao& chave, double custo) {
+    size_t posicao = chave.chave & mascara;
+    std::lock_guard<std::mutex> trava(travas[posicao % NUM_TRAVAS]);
+    Entrada& entrada = entradas[posicao];
+    entrada.chave = chave.chave;
+    entrada.verificacao = chave.verificacao;
+    entrada.custo = custo;
+    entrada.ocupada = true;
+}
@@ -0,0 +1,53 @@
+#ifndef CACHE_FITNESS_HPP
+#define CACHE_FITNESS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Chave de uma decodificacao: dois hashes de 64 bits independentes da LCR ordenada
+// (o segundo confirma o primeiro, entao uma colisao exigiria coincidir em 128 bits)
+struct ChaveDecodificacao {
+    uint64_t chave = 0;
+    uint64_t verificacao = 0;
+};
+
+// Cache concorrente de fitness, indexado pela LCR ordenada do cromossomo.
+// O decodificador so guarda um custo quando ele nao depende do restante da lista de prioridades
+// (ver decodificar), entao um acerto devolve exatamente o custo que a decodificacao produziria.
+// Tabela de mapeamento direto (uma entrada por posicao, a mais recente substitui a anterior),
+// com as posicoes divididas entre NUM_TRAVAS mutexes para que as threads do pool raramente disputem a mesma trava.
+class CacheFitness {
+public:
+    //capacidade é arredondada para a potencia de 2 seguinte (0 = cache desativado)
+    explicit CacheFitness(int capacidade);
+
+    bool ativo() const { return !entradas.empty(); }
+
+    //retorna true e preenche custo se a chave estiver no cache
+    bool buscar(const ChaveDecodificacao& chave, double& custo);
+    void inserir(const ChaveDecodificacao& chave, double custo);
+
+    long long consultas() const { return num_consultas.load(std::memory_order_relaxed); }
+    long long acertos() const { return num_acertos.load(std::memory_order_relaxed); }
+
+private:
+    static const int NUM_TRAVAS = 64;
+
+    struct Entrada {
+        uint64_t chave = 0;
+        uint64_t verificacao = 0;
+        double custo = 0.0;
+        bool ocupada = false;
+    };
+
+    std::vector<Entrada> entradas;
+    uint64_t mascara = 0;
+    std::unique_ptr<std::mutex[]> travas;
+    std::atomic<long long> num_consultas{0};
+    std::atomic<long long> num_acertos{0};
+};
+
+#endif // CACHE_FITNESS_HPP
@@ -1,68 +1,330 @@
 #include "decodificador.hpp"
 #include "scp_cs_data.hpp"
+#include "gerador_aleatorio.hpp"
 #include <set>
 #include <vector>
 #include <algorithm>
 #include <limits>
 #include <numeric>
+#include <functional>
+#include <bitset>
+#include <cstdint>
+
+//contagem vetorial dos elementos novos na incidencia em bits, escolhida na compilacao pelo -march
+//(AVX-512 com VPOPCNTDQ, AVX2 com tabela de nibbles ou popcount de 64 bits portavel)
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+#define CONTAGEM_BITS_AVX512
+#include <immintrin.h>
+#elif defined(__AVX2__)
+#define CONTAGEM_BITS_AVX2
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
-//recebe os genes de um cromossomo, constroi uma solucao e retorna o custo dela
-double decodificar(std::vector<float> genes, const SCPCSInstance& instancia) {
+//dimensiona os buffers para a instancia (so aloca quando a instancia é maior que a anterior)
+//e os limpa para uma nova decodificacao
+void ContextoDecodificador::preparar(const SCPCSInstance& instancia) {
     int m = instancia.num_elementos;
     int n = instancia.num_subconjuntos;
 
-    //vetor booleano para rastrear elementos cobertos
-    std::vector<bool> elementos_cobertos_mask(m, false);
-    int elementos_cobertos_count = 0; 
+    elemento_coberto.assign(m, 0);
+    cobertura_bits.assign(instancia.incidencia_bits.palavras_por_linha, 0);
+    ja_processado.assign(n, 0);
+    //somente o acumulador de penalidades do tipo de custo da variante é usado
+    if (instancia.variante.conflitos != CONFLITOS_NENHUM) {
+        if (instancia.variante.custo == CUSTO_INTEIRO) penalidade_conf_inteira.assign(n, 0);
+        else penalidade_conf.assign(n, 0.0);
+    }
+    novos.resize(n);
+    gene_prioridades.resize(n);
+    selecionados.clear();
+    selecionados.reserve(n);
+    empate_fora_lcr = false;
+    acerto_cache = false;
+    usou_fora_lcr = false;
+    heap_lcr.clear();
+    heap_lcr.reserve(n);
+    heap_restante.clear();
+    heap_restante.reserve(n);
+}
 
-    //rastreia a solução sendo construída
-    std::set<int> subconjuntos_selecionados;
-    std::vector<bool> ja_processado(n, false); //rastreia subconjuntos já avaliados/usados
+//tamanho da LCR (ex: 20% da população, no mínimo 1)
+int tamanho_lcr(int n) {
+    return std::max(1, (int)(n * 0.20));
+}
 
-    //acumulador de custo (retorno da funcao)
-    double custo_total_acumulado = 0.0;
+//ordem das prioridades: gene decrescente, com empate desfeito pelo menor indice
+//(ordem total, para que a ordenacao parcial e a completa produzam exatamente a mesma sequencia)
+static bool maior_prioridade(const std::pair<float, int>& a, const std::pair<float, int>& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
 
-    //gene_prioridades é um vetor de pares (gene, indice subconjunto) 
-    std::vector<std::pair<float, int>> gene_prioridades;
-    gene_prioridades.reserve(n);
+//monta os pares (gene, indice subconjunto) e ordena somente as tamanho_prefixo primeiras posicoes
+//(a LCR): nth_element separa os de maior prioridade e apenas eles sao ordenados, pois o laco guloso
+//quase sempre le so a LCR. O restante fica particionado ate que completar_ordenacao seja chamada
+static void ordenar_prioridades(Intervalo<float> genes, std::vector<std::pair<float, int>>& gene_prioridades,
+                                int tamanho_prefixo) {
+    int n = genes.size();
     for (int j = 0; j < n; ++j) {
-        gene_prioridades.push_back({genes[j], j});
+        gene_prioridades[j] = {genes[j], j};
+    }
+    if (tamanho_prefixo < n) {
+        std::nth_element(gene_prioridades.begin(), gene_prioridades.begin() + tamanho_prefixo,
+                         gene_prioridades.end(), maior_prioridade);
+        std::sort(gene_prioridades.begin(), gene_prioridades.begin() + tamanho_prefixo, maior_prioridade);
+    } else {
+        std::sort(gene_prioridades.begin(), gene_prioridades.end(), maior_prioridade);
+    }
+}
+
+//ordena as posicoes fora da LCR (usado apenas quando a busca precisa ir alem da LCR)
+static void completar_ordenacao(std::vector<std::pair<float, int>>& gene_prioridades, int tamanho_prefixo) {
+    if (tamanho_prefixo < (int)gene_prioridades.size()) {
+        std::sort(gene_prioridades.begin() + tamanho_prefixo, gene_prioridades.end(), maior_prioridade);
+    }
+}
+
+static inline int contar_bits(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#else
+    return (int)std::bitset<64>(x).count();
+#endif
+}
+
+//numero de bits de linha ausentes de cobertura, isto é, popcount(linha & ~cobertura)
+//(palavras é multiplo de MatrizBits::PALAVRAS_BLOCO)
+static inline int contar_novos_bits(const uint64_t* linha, const uint64_t* cobertura, int palavras) {
+#if defined(CONTAGEM_BITS_AVX512)
+    //(andnot com mascara completa: a forma sem mascara gera um falso aviso de variavel nao inicializada no gcc 12)
+    const __mmask8 inteira = 0xFF, metade = 0x0F;
+    __m512i acumulado = _mm512_setzero_si512();
+    int w = 0;
+    for (; w + 8 <= palavras; w += 8) {
+        __m512i novos = _mm512_maskz_andnot_epi64(inteira, _mm512_loadu_si512(cobertura + w), _mm512_loadu_si512(linha + w));
+        acumulado = _mm512_add_epi64(acumulado, _mm512_popcnt_epi64(novos));
+    }
+    if (w < palavras) { //bloco final de 4 palavras
+        __m512i novos = _mm512_maskz_andnot_epi64(metade, _mm512_maskz_loadu_epi64(metade, cobertura + w),
+                                                  _mm512_maskz_loadu_epi64(metade, linha + w));
+        acumulado = _mm512_add_epi64(acumulado, _mm512_popcnt_epi64(novos));
+    }
+    uint64_t parciais[8];
+    _mm512_storeu_si512(parciais, acumulado);
+    return (int)(parciais[0] + parciais[1] + parciais[2] + parciais[3] + parciais[4] + parciais[5] + parciais[6] + parciais[7]);
+#elif defined(CONTAGEM_BITS_AVX2)
+    //popcount por bytes com a tabela dos 16 nibbles (vpshufb), somado em palavras de 64 bits por vpsadbw
+    const __m256i tabela = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    __m256i acumulado = _mm256_setzero_si256();
+    for (int w = 0; w < palavras; w += 4) {
+        __m256i novos = _mm256_andnot_si256(_mm256_loadu_si256((const __m256i*)(cobertura + w)),
+                                            _mm256_loadu_si256((const __m256i*)(linha + w)));
+        __m256i baixo = _mm256_shuffle_epi8(tabela, _mm256_and_si256(novos, nibble));
+        __m256i alto = _mm256_shuffle_epi8(tabela, _mm256_and_si256(_mm256_srli_epi16(novos, 4), nibble));
+        acumulado = _mm256_add_epi64(acumulado, _mm256_sad_epu8(_mm256_add_epi8(baixo, alto), _mm256_setzero_si256()));
+    }
+    return (int)(_mm256_extract_epi64(acumulado, 0) + _mm256_extract_epi64(acumulado, 1) +
+                 _mm256_extract_epi64(acumulado, 2) + _mm256_extract_epi64(acumulado, 3));
+#else
+    int novos = 0;
+    for (int w = 0; w < palavras; ++w) {
+        novos += contar_bits(linha[w] & ~cobertura[w]);
+    }
+    return novos;
+#endif
+}
+
+//politicas das variantes do decodificador (ver VarianteDecodificador em scp_cs_data.hpp)
+//cada combinacao é instanciada em tempo de compilacao e escolhida uma vez por decodificacao em com_variante
+
+//largura dos indices: de onde vem as incidencias e os vizinhos do grafo esparso
+struct Indices32 {
+    using Tipo = int;
+    static const MatrizCSR<int>& matriz(const SCPCSInstance& instancia) { return instancia.matriz_incidencia; }
+    static const MatrizCSR<int>& lista(const SCPCSInstance& instancia) { return instancia.lista_incidencia; }
+    static const int* vizinhos(const SCPCSInstance& instancia) { return instancia.conflitos.vizinhos.data(); }
+};
+struct Indices16 {
+    using Tipo = uint16_t;
+    static const MatrizCSR<uint16_t>& matriz(const SCPCSInstance& instancia) { return instancia.especializada.matriz_incidencia16; }
+    static const MatrizCSR<uint16_t>& lista(const SCPCSInstance& instancia) { return instancia.especializada.lista_incidencia16; }
+    static const uint16_t* vizinhos(const SCPCSInstance& instancia) { return instancia.especializada.vizinhos16.data(); }
+};
+
+//tipo do custo: Valor é a penalidade acumulada de um candidato e Total o custo da solucao
+//(as somas de inteiros sao exatas, entao as duas variantes produzem o mesmo custo e a mesma metrica gulosa)
+struct CustoReal {
+    using Valor = double;
+    using Total = double;
+    static const double* penalidades(const SCPCSInstance& instancia) { return instancia.conflitos.penalidades.data(); }
+    static const double* matriz_densa(const SCPCSInstance& instancia) { return instancia.especializada.conflitos_densos_reais.data(); }
+    static std::vector<double>& acumuladas(ContextoDecodificador& ctx) { return ctx.penalidade_conf; }
+};
+struct CustoInteiro {
+    using Valor = int32_t;
+    using Total = int64_t;
+    static const int32_t* penalidades(const SCPCSInstance& instancia) { return instancia.especializada.penalidades_inteiras.data(); }
+    static const int32_t* matriz_densa(const SCPCSInstance& instancia) { return instancia.especializada.conflitos_densos_inteiros.data(); }
+    static std::vector<int32_t>& acumuladas(ContextoDecodificador& ctx) { return ctx.penalidade_conf_inteira; }
+};
+
+//modelos de conflito: penalidade(j) é a soma das penalidades entre j e os subconjuntos ja selecionados,
+//propagar(j) a atualiza quando j é selecionado e penalidade_solucao soma os pares em conflito de uma solucao
+template <typename Indices, typename Custo>
+struct SemConflitos {
+    using Valor = typename Custo::Valor;
+
+    SemConflitos(const SCPCSInstance&, ContextoDecodificador&) {}
+    Valor penalidade(int) const { return 0; }
+    void propagar(int) {}
+    static typename Custo::Total penalidade_solucao(const std::set<int>&, const SCPCSInstance&) { return 0; }
+};
+
+template <typename Indices, typename Custo>
+struct ConflitosEsparsos {
+    using Valor = typename Custo::Valor;
+    const int* inicio;
+    const typename Indices::Tipo* vizinhos;
+    const Valor* penalidades;
+    Valor* acumulada;
+
+    ConflitosEsparsos(const SCPCSInstance& instancia, ContextoDecodificador& ctx)
+        : inicio(instancia.conflitos.inicio.data()), vizinhos(Indices::vizinhos(instancia)),
+          penalidades(Custo::penalidades(instancia)), acumulada(Custo::acumuladas(ctx).data()) {}
+
+    Valor penalidade(int j) const { return acumulada[j]; }
+
+    //percorre apenas os vizinhos do subconjunto escolhido
+    void propagar(int j) {
+        for (int p = inicio[j]; p < inicio[j + 1]; ++p) {
+            acumulada[vizinhos[p]] += penalidades[p];
+        }
+    }
+
+    //como o grafo de conflitos é simetrico, cada par é contado apenas uma vez (vizinho > sub_i)
+    static typename Custo::Total penalidade_solucao(const std::set<int>& subconjuntos, const SCPCSInstance& instancia) {
+        const GrafoConflitos& conflitos = instancia.conflitos;
+        const typename Indices::Tipo* vizinhos = Indices::vizinhos(instancia);
+        const Valor* penalidades = Custo::penalidades(instancia);
+        std::vector<char> na_solucao(instancia.num_subconjuntos, 0);
+        for (int j : subconjuntos) na_solucao[j] = 1;
+
+        typename Custo::Total total = 0;
+        for (int sub_i : subconjuntos) {
+            for (int p = conflitos.inicio[sub_i]; p < conflitos.inicio[sub_i + 1]; ++p) {
+                int sub_j = vizinhos[p];
+                if (sub_j > sub_i && na_solucao[sub_j]) {
+                    total += penalidades[p];
+                }
+            }
+        }
+        return total;
+    }
+};
+
+template <typename Indices, typename Custo>
+struct ConflitosDensos {
+    using Valor = typename Custo::Valor;
+    const Valor* matriz;
+    int n;
+    Valor* acumulada;
+
+    ConflitosDensos(const SCPCSInstance& instancia, ContextoDecodificador& ctx)
+        : matriz(Custo::matriz_densa(instancia)), n(instancia.num_subconjuntos), acumulada(Custo::acumuladas(ctx).data()) {}
+
+    Valor penalidade(int j) const { return acumulada[j]; }
+
+    //soma contigua da linha de j (vetorizada pelo compilador; os zeros dos pares sem conflito nao mudam nada)
+    void propagar(int j) {
+        const Valor* linha = matriz + (size_t)j * n;
+        for (int v = 0; v < n; ++v) {
+            acumulada[v] += linha[v];
+        }
+    }
+
+    //consulta direta de cada par da solucao (o conjunto é ordenado, entao cada par é visitado uma vez)
+    static typename Custo::Total penalidade_solucao(const std::set<int>& subconjuntos, const SCPCSInstance& instancia) {
+        const Valor* matriz = Custo::matriz_densa(instancia);
+        size_t n = instancia.num_subconjuntos;
+        typename Custo::Total total = 0;
+        for (auto sub_i = subconjuntos.begin(); sub_i != subconjuntos.end(); ++sub_i) {
+            const Valor* linha = matriz + *sub_i * n;
+            for (auto sub_j = std::next(sub_i); sub_j != subconjuntos.end(); ++sub_j) {
+                total += linha[*sub_j];
+            }
+        }
+        return total;
     }
-    //ordenar gene_prioridade em ordem decrescente pela prioridade do subconjunto
-    std::sort(gene_prioridades.begin(), gene_prioridades.end(),
-              [](const auto& a, const auto& b) { return a.first > b.first; });
-    
+};
+
+//decodificador original: a cada iteracao varre a LCR (e, se necessario, o restante da lista)
+//recontando os elementos novos de cada candidato
+//(COBERTURA_BITS: a cobertura é mantida em bits e a contagem é feita com popcount, ver MatrizBits)
+template <template <class, class> class Conflitos, typename Indices, typename Custo, bool COBERTURA_BITS>
+static double decodificar_varredura(const SCPCSInstance& instancia, ContextoDecodificador& ctx) {
+    int m = instancia.num_elementos;
+    int n = instancia.num_subconjuntos;
+
+    //buffers reaproveitados: elemento_coberto rastreia os elementos cobertos,
+    //ja_processado os subconjuntos ja usados e selecionados a solucao sendo construida
+    std::vector<char>& elementos_cobertos_mask = ctx.elemento_coberto;
+    std::vector<char>& ja_processado = ctx.ja_processado;
+    int elementos_cobertos_count = 0; 
+    const MatrizCSR<typename Indices::Tipo>& incidencia = Indices::matriz(instancia);
+
+    //conflitos.penalidade(j) é a soma das penalidades de conflito entre j e os subconjuntos ja selecionados
+    //(atualizada a cada selecao, de acordo com o modelo de conflitos da instancia)
+    Conflitos<Indices, Custo> conflitos(instancia, ctx);
+    using Valor = typename Custo::Valor;
+
+    //acumulador de custo (retorno da funcao)
+    typename Custo::Total custo_total_acumulado = 0;
+
     //tamanho da LCR (ex: 20% da população, no mínimo 1)
-    const int TAMANHO_LCR = std::max(1, (int)(n * 0.20)); 
+    const int TAMANHO_LCR = tamanho_lcr(n);
+
+    //gene_prioridades é um vetor de pares (gene, indice subconjunto), em ordem decrescente de gene
+    //(somente a LCR chega ordenada; o restante é ordenado na primeira busca fora dela)
+    std::vector<std::pair<float, int>>& gene_prioridades = ctx.gene_prioridades;
+    bool ordenacao_completa = false;
+
+    const MatrizBits& incidencia_bits = instancia.incidencia_bits;
+    const int palavras = incidencia_bits.palavras_por_linha;
+    uint64_t* cobertura_bits = ctx.cobertura_bits.data();
+
+    //elementos do subconjunto j ainda nao cobertos pela solucao atual
+    auto contar_novos = [&](int j) {
+        if constexpr (COBERTURA_BITS) {
+            return contar_novos_bits(incidencia_bits.linha(j), cobertura_bits, palavras);
+        } else {
+            int novos = 0;
+            for (auto e : incidencia[j]) {
+                if (!elementos_cobertos_mask[e]) novos++;
+            }
+            return novos;
+        }
+    };
 
     //loop principal: Continua enquanto a cobertura não for total
     while (elementos_cobertos_count < m) {
         double melhor_metrica = std::numeric_limits<double>::max(); 
         int melhor_indice = -1;
-        double custo_efetivo_do_melhor = 0.0; //armazena o custo do vencedor
+        Valor custo_efetivo_do_melhor = 0; //armazena o custo do vencedor
 
         //busca na lcr
         for (int i = 0; i < std::min((int)gene_prioridades.size(), TAMANHO_LCR); ++i) {
             int j = gene_prioridades[i].second; //indice do subconjunto
             if (ja_processado[j]) continue;
             //verifica se o subconjunto adiciona algum novo elemento a solucao atual
-            int novos = 0;
-            for (int e : instancia.matriz_incidencia[j]) {
-                if (!elementos_cobertos_mask[e]) {
-                    novos++;
-                }
-            }
+            int novos = contar_novos(j);
             if (novos == 0) continue; //se o subconjunto nao agrega elemento algum, vá para o proximo da lista
 
-            //calcula os custos de penalidade causados se o subconjunto atual for adicionado
-            double penalidade_conf = 0.0;
-            for (int l : subconjuntos_selecionados) {
-                penalidade_conf += instancia.matriz_conflitos[j][l];
-            }
-            double custo_efetivo = (double)instancia.custos[j] + penalidade_conf;
-            double metrica_gulosa = custo_efetivo / novos; //calcula o quociente do subconjunto
+            //custo do subconjunto somado as penalidades causadas se ele for adicionado (leitura O(1))
+            Valor custo_efetivo = instancia.custos[j] + conflitos.penalidade(j);
+            double metrica_gulosa = (double)custo_efetivo / novos; //calcula o quociente do subconjunto
 
             //se o quociente do subconjunto atual é menor que o menor quociente
             //encontrado até agora, o subconjunto atual é o novo melhor candidato
@@ -74,28 +336,30 @@ double decodificar(std::vector<float> genes, const SCPCSInstance& instancia) {
         }
         //se nenhum subconjunto da lcr é viavel, realizar a busca no restante dos subconjuntos
         if (melhor_indice == -1) {
+            if (!ordenacao_completa) {
+                completar_ordenacao(gene_prioridades, TAMANHO_LCR);
+                ordenacao_completa = true;
+                ctx.usou_fora_lcr = true;
+            }
+            bool empate = false; //outro candidato com a metrica do melhor (vence o de menor posicao)
             for (int i = TAMANHO_LCR; i < n; ++i) {//a busca é feita da mesma maneira que na lcr 
                 int j = gene_prioridades[i].second;
                 if (ja_processado[j]) continue;
-                int novos = 0;
-
-                for (int e : instancia.matriz_incidencia[j]) {
-                    if (!elementos_cobertos_mask[e]) novos++;
-                }
+                int novos = contar_novos(j);
                 if (novos == 0) continue;
 
-                double penalidade_conf = 0.0;
-                for (int l : subconjuntos_selecionados) {
-                    penalidade_conf += instancia.matriz_conflitos[j][l];
-                }
-                double custo_efetivo = (double)instancia.custos[j] + penalidade_conf;
-                double metrica_gulosa = custo_efetivo / novos;
+                Valor custo_efetivo = instancia.custos[j] + conflitos.penalidade(j);
+                double metrica_gulosa = (double)custo_efetivo / novos;
                 if (metrica_gulosa < melhor_metrica) {
                     melhor_metrica = metrica_gulosa;
                     melhor_indice = j;
                     custo_efetivo_do_melhor = custo_efetivo;
+                    empate = false;
+                } else if (metrica_gulosa == melhor_metrica) {
+                    empate = true;
                 }
             }
+            if (empate) ctx.empate_fora_lcr = true;
         }
         if (melhor_indice == -1) {
             break; //se nao foi encontrado nenhum candidato viavel, interromper a funcao
@@ -104,200 +368,238 @@ double decodificar(std::vector<float> genes, const SCPCSInstance& instancia) {
         custo_total_acumulado += custo_efetivo_do_melhor;
 
         //adiciona os novos elementos do candidato selecionado a cobertura atual da solucao  
-        for (int e : instancia.matriz_incidencia[melhor_indice]) {
-            if (!elementos_cobertos_mask[e]) {
-                elementos_cobertos_mask[e] = true;
-                elementos_cobertos_count++;
+        if constexpr (COBERTURA_BITS) {
+            const uint64_t* linha = incidencia_bits.linha(melhor_indice);
+            for (int w = 0; w < palavras; ++w) {
+                uint64_t novos_bits = linha[w] & ~cobertura_bits[w];
+                elementos_cobertos_count += contar_bits(novos_bits);
+                cobertura_bits[w] |= novos_bits;
+            }
+        } else {
+            for (auto e : incidencia[melhor_indice]) {
+                if (!elementos_cobertos_mask[e]) {
+                    elementos_cobertos_mask[e] = 1;
+                    elementos_cobertos_count++;
+                }
             }
         }
-        //adiciona à lista de selecionados (para o calculo de conflito da proxima iteracao)
-        subconjuntos_selecionados.insert(melhor_indice);
-        ja_processado[melhor_indice] = true; 
+        //propaga as penalidades do selecionado para os seus vizinhos no grafo de conflitos
+        conflitos.propagar(melhor_indice);
+        //adiciona à lista de selecionados
+        ctx.selecionados.push_back(melhor_indice);
+        ja_processado[melhor_indice] = 1; 
     }
-    return custo_total_acumulado;
+    return (double)custo_total_acumulado;
 }
 
-double calcular_custo_solucao(const std::set<int>& subconjuntos_selecionados, SCPCSInstance& instancia){
-    double custo_total = 0.0;
+//decodificador com fila de prioridade preguicosa: produz exatamente a mesma solucao que decodificar_varredura,
+//mas mantem novos[j] (elementos ainda descobertos de j) e a penalidade de j de forma incremental
+//e guarda os candidatos em um heap ordenado por (metrica gulosa, posicao na lista de prioridades)
+//como a metrica de um candidato so pode aumentar (novos diminui e a penalidade cresce), uma entrada
+//desatualizada no topo do heap é apenas recalculada e reinserida, sem necessidade de remocao explicita
+template <template <class, class> class Conflitos, typename Indices, typename Custo>
+static double decodificar_fila_prioridade(const SCPCSInstance& instancia, ContextoDecodificador& ctx) {
+    int m = instancia.num_elementos;
+    int n = instancia.num_subconjuntos;
+    const MatrizCSR<typename Indices::Tipo>& incidencia = Indices::matriz(instancia);
+    const MatrizCSR<typename Indices::Tipo>& lista_incidencia = Indices::lista(instancia);
+    Conflitos<Indices, Custo> conflitos(instancia, ctx);
 
-    //vetor de indices
-    std::vector<int> selecionados(subconjuntos_selecionados.begin(), subconjuntos_selecionados.end());
+    std::vector<char>& elementos_cobertos_mask = ctx.elemento_coberto;
+    std::vector<char>& ja_processado = ctx.ja_processado;
+    int elementos_cobertos_count = 0;
+    typename Custo::Total custo_total_acumulado = 0;
 
-    //soma dos custos dos subconjuntos
-    for (int j : selecionados) {
-        custo_total += instancia.custos[j];
+    //novos[j] é o numero de elementos de j ainda nao cobertos (decrementado via lista_incidencia)
+    std::vector<int>& novos = ctx.novos;
+    for (int j = 0; j < n; ++j) {
+        novos[j] = incidencia[j].size();
     }
 
-    //soma das penalidades de conflito
-    //como a matriz de conflitos é simetrica, não precisa ser percorrida por completo
-    for (size_t i = 0; i < selecionados.size(); ++i) {
-        int sub_i = selecionados[i];
-        const auto& linha_conflito = instancia.matriz_conflitos[sub_i];
-
-        for (size_t j = i + 1; j < selecionados.size(); ++j) {
-            int sub_j = selecionados[j];
-            custo_total += linha_conflito[sub_j];
+    const int TAMANHO_LCR = tamanho_lcr(n);
+    std::vector<std::pair<float, int>>& gene_prioridades = ctx.gene_prioridades;
+
+    //entrada do heap: (metrica gulosa, posicao na lista de prioridades, subconjunto)
+    //o desempate pela posicao reproduz a escolha do primeiro candidato de menor metrica na varredura
+    using Entrada = ContextoDecodificador::EntradaHeap;
+    const std::greater<Entrada> ordem_heap; //heap de minimo sobre os vetores do contexto
+
+    auto metrica = [&](int j) {
+        return (double)(instancia.custos[j] + conflitos.penalidade(j)) / novos[j];
+    };
+    //preenche o heap com as posicoes [inicio, fim) da lista de prioridades
+    auto construir_heap = [&](std::vector<Entrada>& heap, int inicio, int fim) {
+        for (int i = inicio; i < fim; ++i) {
+            int j = gene_prioridades[i].second;
+            if (!ja_processado[j] && novos[j] > 0) {
+                heap.emplace_back(metrica(j), i, j);
+            }
         }
-    }
-    return custo_total;
-}
-
-//a busca local é aplicada somente uma vez: no melhor individuo da ultima populacao
-//ela serve para remover subconjuntos redundantes, que nao possuem, exclusivamente, nenhum elemento 
-std::set<int> busca_local_remocao(std::set<int> solucao_inicial, SCPCSInstance& instancia, double& custo_inicial) {
-    std::set<int> solucao_atual = solucao_inicial;
-    bool mudanca_feita = true;
-    double custo_atual = custo_inicial;
-
-    //converte o set para vector e ordena pelo custo (tentar remover o mais caro primeiro)
-    std::vector<int> candidatos(solucao_inicial.begin(), solucao_inicial.end());
-    //ordena de forma decrescente
-    std::sort(candidatos.begin(), candidatos.end(), 
-        [&](int a, int b) {
-            return instancia.custos[a] > instancia.custos[b];
-        });
-
-    while(mudanca_feita){
-        mudanca_feita = false;
-
-        //tentamos remover cada subconjunto (do mais caro para o mais barato)
-        for(int indice_sub_j : candidatos){
-            //verifica se o subconjunto j ainda está na solução
-            if (solucao_atual.find(indice_sub_j) == solucao_atual.end()) {
-                continue; //ja foi removido anteriormente
+        std::make_heap(heap.begin(), heap.end(), ordem_heap);
+    };
+    //retorna o candidato de menor metrica do heap (ou -1 se o heap esvaziar)
+    auto extrair_melhor = [&](std::vector<Entrada>& heap) {
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), ordem_heap);
+            auto [metrica_salva, posicao, j] = heap.back();
+            heap.pop_back();
+            if (ja_processado[j] || novos[j] == 0) continue; //candidato que nao agrega mais elementos
+            double metrica_atual = metrica(j);
+            if (metrica_atual != metrica_salva) { //entrada desatualizada: reinsere com a metrica atual
+                heap.emplace_back(metrica_atual, posicao, j);
+                std::push_heap(heap.begin(), heap.end(), ordem_heap);
+                continue;
             }
-            bool pode_remover = true;
-
-            //para cada elemento i coberto por j...
-            for(int elemento_i : instancia.matriz_incidencia[indice_sub_j]){
-                //verificador de cobertura
-                bool coberto_por_substituto = false;
-
-                //itera sobre subconjuntos k que cobrem i (usando lista_incidencia)
-                for(int subconjunto_k : instancia.lista_incidencia[elemento_i]){
-                    //se K não for o próprio J E K estiver na solução, achar um substituto
-                    if (subconjunto_k != indice_sub_j && solucao_atual.count(subconjunto_k)){
-                        coberto_por_substituto = true;
-                        break; 
-                    }
-                }
-                //se nao for coberto por nenhum substituto, j é essencial
-                if(!coberto_por_substituto){
-                    pode_remover = false;
-                    break; //'j' é essencial para manter a cobertura total, não pode ser removido
-                }
+            return j;
+        }
+        return -1;
+    };
+
+    std::vector<Entrada>& heap_lcr = ctx.heap_lcr;
+    std::vector<Entrada>& heap_restante = ctx.heap_restante; //candidatos fora da LCR, construido somente se a LCR se esgotar
+    construir_heap(heap_lcr, 0, std::min(n, TAMANHO_LCR));
+    bool restante_construido = false;
+
+    while (elementos_cobertos_count < m) {
+        int melhor_indice = extrair_melhor(heap_lcr);
 
+        //um candidato da LCR com novos == 0 nunca volta a ser viavel, entao uma vez esgotada
+        //a LCR todas as iteracoes seguintes sao feitas no restante da lista
+        if (melhor_indice == -1) {
+            if (!restante_construido) {
+                completar_ordenacao(gene_prioridades, TAMANHO_LCR);
+                construir_heap(heap_restante, TAMANHO_LCR, n);
+                restante_construido = true;
+                ctx.usou_fora_lcr = true;
+            }
+            melhor_indice = extrair_melhor(heap_restante);
+            //empate possivel se a proxima entrada tem a mesma metrica salva (ela pode estar desatualizada,
+            //entao a marcacao é conservadora)
+            if (melhor_indice != -1 && !heap_restante.empty() &&
+                std::get<0>(heap_restante.front()) == metrica(melhor_indice)) {
+                ctx.empate_fora_lcr = true;
             }
+        }
+        if (melhor_indice == -1) break;
+
+        custo_total_acumulado += instancia.custos[melhor_indice] + conflitos.penalidade(melhor_indice);
 
-            if(pode_remover){
-                double custo_remocao_delta = instancia.custos[indice_sub_j];
-                //subtrair as penalidades de conflito perdidas
-                for (int sub_k : solucao_atual) {
-                    if (sub_k != indice_sub_j) {
-                        custo_remocao_delta += instancia.matriz_conflitos[indice_sub_j][sub_k];
-                    }
+        //cada elemento novo coberto decrementa novos[] de todos os subconjuntos que o cobrem
+        for (auto e : incidencia[melhor_indice]) {
+            if (!elementos_cobertos_mask[e]) {
+                elementos_cobertos_mask[e] = 1;
+                elementos_cobertos_count++;
+                for (auto s : lista_incidencia[e]) {
+                    novos[s]--;
                 }
-                //o movimento é sempre de melhoria, pois estamos só removendo.
-                
-                //aplicar remocao
-                solucao_atual.erase(indice_sub_j);
-                custo_atual -= custo_remocao_delta; //atualiza o custo global
-                mudanca_feita = true; 
-
-                break; //recomeca o while para re-avaliar a nova solução
-            } 
+            }
         }
+        conflitos.propagar(melhor_indice);
+        ctx.selecionados.push_back(melhor_indice);
+        ja_processado[melhor_indice] = 1;
     }
-
-    custo_inicial = custo_atual;
-
-    return solucao_atual;
-
+    return (double)custo_total_acumulado;
 }
 
-//versao alternativa da funcao decodificar, que retorna o conjunto de subconjuntos selecionados
-//utilizada para exibir quais os subconjuntos da melhor solucao encontrada ao final
-std::set<int> decodificar_para_solucao(std::vector<float> genes, const SCPCSInstance& instancia) {
-    int m = instancia.num_elementos;
-    int n = instancia.num_subconjuntos;
-
-    std::vector<bool> elementos_cobertos_mask(m, false);
-    int elementos_cobertos_count = 0; 
-    std::set<int> subconjuntos_selecionados;
-    std::vector<bool> ja_processado(n, false); 
-
-    std::vector<std::pair<float, int>> gene_prioridades;
-    gene_prioridades.reserve(n);
-    for (int j = 0; j < n; ++j) {
-        gene_prioridades.push_back({genes[j], j});
+//modelo de conflitos usado como argumento no despacho das variantes
+template <template <class, class> class Conflitos>
+struct Modelo {};
+
+//chama funcao(Modelo<Conflitos>{}, Indices{}, Custo{}) com as politicas da variante escolhida para a instancia
+template <typename Funcao>
+static double com_variante(const VarianteDecodificador& variante, Funcao funcao) {
+    auto com_custo = [&](auto modelo, auto indices) {
+        if (variante.custo == CUSTO_INTEIRO) return funcao(modelo, indices, CustoInteiro{});
+        return funcao(modelo, indices, CustoReal{});
+    };
+    auto com_indices = [&](auto modelo) {
+        if (variante.indices == INDICES_16) return com_custo(modelo, Indices16{});
+        return com_custo(modelo, Indices32{});
+    };
+    switch (variante.conflitos) {
+        case CONFLITOS_NENHUM: return com_indices(Modelo<SemConflitos>{});
+        case CONFLITOS_DENSOS: return com_indices(Modelo<ConflitosDensos>{});
+        default: return com_indices(Modelo<ConflitosEsparsos>{});
     }
-    std::sort(gene_prioridades.begin(), gene_prioridades.end(),
-              [](const auto& a, const auto& b) { return a.first > b.first; });
-
-    const int TAMANHO_LCR = std::max(1, (int)(n * 0.20)); 
+}
 
-    while (elementos_cobertos_count < m) {
-        double melhor_metrica = std::numeric_limits<double>::max(); 
-        int melhor_indice = -1;
-        //busca na LCR
-        for (int i = 0; i < std::min((int)gene_prioridades.size(), TAMANHO_LCR); ++i) {
-            int j = gene_prioridades[i].second; 
-            if (ja_processado[j]) continue;
+template <template <class, class> class Conflitos, typename Indices, typename Custo>
+static double decodificar_variante(Modelo<Conflitos>, Indices, Custo, const SCPCSInstance& instancia,
+                                   ContextoDecodificador& ctx, ModoDecodificador modo) {
+    if (modo == DECODIFICADOR_FILA_PRIORIDADE) return decodificar_fila_prioridade<Conflitos, Indices, Custo>(instancia, ctx);
+    if (!instancia.incidencia_bits.vazia()) return decodificar_varredura<Conflitos, Indices, Custo, true>(instancia, ctx);
+    return decodificar_varredura<Conflitos, Indices, Custo, false>(instancia, ctx);
+}
 
-            int novos = 0;
-            for (int e : instancia.matriz_incidencia[j]) {
-                if (!elementos_cobertos_mask[e]) novos++;
-            }
-            if (novos == 0) continue; 
+template <template <class, class> class Conflitos, typename Indices, typename Custo>
+static double custo_solucao_variante(Modelo<Conflitos>, Indices, Custo, const std::set<int>& subconjuntos,
+                                     const SCPCSInstance& instancia) {
+    typename Custo::Total custo_total = 0;
+    for (int j : subconjuntos) {
+        custo_total += instancia.custos[j];
+    }
+    custo_total += Conflitos<Indices, Custo>::penalidade_solucao(subconjuntos, instancia);
+    return (double)custo_total;
+}
 
-            double penalidade_conf = 0.0;
-            for (int l : subconjuntos_selecionados) {
-                penalidade_conf += instancia.matriz_conflitos[j][l];
-            }
-            double custo_efetivo = (double)instancia.custos[j] + penalidade_conf;
-            double metrica_gulosa = custo_efetivo / novos;
+//chave do cache: hashes da sequencia de subconjuntos da LCR ordenada
+static ChaveDecodificacao chave_lcr(const std::vector<std::pair<float, int>>& gene_prioridades, int tamanho_prefixo) {
+    ChaveDecodificacao chave{0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL};
+    for (int i = 0; i < tamanho_prefixo; ++i) {
+        uint64_t j = (uint64_t)gene_prioridades[i].second + 1;
+        chave.chave = FluxoAleatorio::misturar(chave.chave + j * FluxoAleatorio::PHI);
+        chave.verificacao = FluxoAleatorio::misturar(chave.verificacao ^ (j * 0xD6E8FEB86659FD93ULL));
+    }
+    return chave;
+}
 
-            if (metrica_gulosa < melhor_metrica) {
-                melhor_metrica = metrica_gulosa;
-                melhor_indice = j;
-            }
-        } 
-        //busca fora da lcr
-        if (melhor_indice == -1) {
-            for (int i = TAMANHO_LCR; i < n; ++i) { 
-                int j = gene_prioridades[i].second;
-                if (ja_processado[j]) continue;
+//recebe os genes de um cromossomo, constroi uma solucao e retorna o custo dela
+//os subconjuntos selecionados ficam em ctx.selecionados (na ordem em que foram escolhidos)
+//com cache, o custo pode vir de uma decodificacao anterior com a mesma LCR ordenada (ctx.acerto_cache,
+//e ctx.selecionados fica vazio). A escolha gulosa depende do cromossomo somente pela LCR ordenada e,
+//quando ela se esgota, pela ordem do restante apenas para desempatar candidatos de mesma metrica;
+//por isso so sao guardados os custos das decodificacoes sem empate fora da LCR, que valem para
+//qualquer cromossomo com a mesma LCR e o cache nunca muda o resultado
+double decodificar(Intervalo<float> genes, const SCPCSInstance& instancia, ContextoDecodificador& ctx, ModoDecodificador modo,
+                   CacheFitness* cache) {
+    ctx.preparar(instancia);
+    const int TAMANHO_LCR = tamanho_lcr(instancia.num_subconjuntos);
+    ordenar_prioridades(genes, ctx.gene_prioridades, TAMANHO_LCR);
+
+    bool usar_cache = cache != nullptr && cache->ativo();
+    ChaveDecodificacao chave;
+    if (usar_cache) {
+        chave = chave_lcr(ctx.gene_prioridades, std::min(TAMANHO_LCR, instancia.num_subconjuntos));
+        double custo;
+        if (cache->buscar(chave, custo)) {
+            ctx.acerto_cache = true;
+            return custo;
+        }
+    }
 
-                int novos = 0;
-                for (int e : instancia.matriz_incidencia[j]) {
-                    if (!elementos_cobertos_mask[e]) novos++;
-                }
-                if (novos == 0) continue;
+    double custo = com_variante(instancia.variante, [&](auto modelo, auto indices, auto tipo_custo) {
+        return decodificar_variante(modelo, indices, tipo_custo, instancia, ctx, modo);
+    });
+    if (usar_cache && !ctx.empate_fora_lcr) cache->inserir(chave, custo);
+    return custo;
+}
 
-                double penalidade_conf = 0.0;
-                for (int l : subconjuntos_selecionados) {
-                    penalidade_conf += instancia.matriz_conflitos[j][l];
-                }
-                double custo_efetivo = (double)instancia.custos[j] + penalidade_conf;
-                double metrica_gulosa = custo_efetivo / novos;
+//versao de conveniencia com um contexto temporario
+//se solucao_saida nao for nulo, os subconjuntos selecionados sao copiados para ele
+//(utilizado para exibir quais os subconjuntos da melhor solucao encontrada ao final)
+double decodificar(Intervalo<float> genes, const SCPCSInstance& instancia, std::set<int>* solucao_saida, ModoDecodificador modo) {
+    ContextoDecodificador ctx;
+    double custo = decodificar(genes, instancia, ctx, modo);
+    if (solucao_saida != nullptr) {
+        solucao_saida->clear();
+        solucao_saida->insert(ctx.selecionados.begin(), ctx.selecionados.end());
+    }
+    return custo;
+}
 
-                if (metrica_gulosa < melhor_metrica) {
-                    melhor_metrica = metrica_gulosa;
-                    melhor_indice = j;
-                }
-            }
-        }
-        if (melhor_indice == -1) break; 
-         
-        for (int e : instancia.matriz_incidencia[melhor_indice]) {
-            if (!elementos_cobertos_mask[e]) {
-                elementos_cobertos_mask[e] = true;
-                elementos_cobertos_count++;
-            }
-        }
-        subconjuntos_selecionados.insert(melhor_indice);
-        ja_processado[melhor_indice] = true; 
-    } 
-    //retorna o conjunto dos subconjuntos selecionados
-    return subconjuntos_selecionados; 
-}
\ No newline at end of file
+double calcular_custo_solucao(const std::set<int>& subconjuntos_selecionados, const SCPCSInstance& instancia){
+    //soma dos custos dos subconjuntos e das penalidades de conflito (pelo modelo de conflitos da instancia)
+    return com_variante(instancia.variante, [&](auto modelo, auto indices, auto tipo_custo) {
+        return custo_solucao_variante(modelo, indices, tipo_custo, subconjuntos_selecionados, instancia);
+    });
+}
@@ -2,9 +2,48 @@
 #define DECODIFICADOR_HPP
 
 #include "scp_cs_data.hpp"
+#include "cache_fitness.hpp"
+#include <cstdint>
 #include <vector>
+#include <tuple>
 
-double decodificar(std::vector<float> genes, const SCPCSInstance& instancia, std::set<int>* solucao_saida = nullptr);
-std::set<int> busca_local_remocao(std::set<int> solucao_inicial, SCPCSInstance& instancia, double& custo_inicial);
+//estrategia usada pelo decodificador guloso (ambas produzem a mesma solucao)
+enum ModoDecodificador {
+    DECODIFICADOR_VARREDURA,       //varre a LCR a cada iteracao recontando os elementos novos
+    DECODIFICADOR_FILA_PRIORIDADE  //contadores incrementais + heap preguicoso de candidatos
+};
+
+// Area de trabalho reutilizavel do decodificador (uma por thread)
+// os buffers sao dimensionados na primeira decodificacao e depois apenas limpos,
+// de modo que decodificacoes seguintes na mesma instancia nao fazem nenhuma alocacao
+struct ContextoDecodificador {
+    //entrada do heap do modo fila de prioridade: (metrica gulosa, posicao na lista de prioridades, subconjunto)
+    using EntradaHeap = std::tuple<double, int, int>;
+
+    std::vector<char> elemento_coberto;   //elemento_coberto[i] != 0 se o elemento i ja esta coberto
+    std::vector<uint64_t> cobertura_bits; //mesma cobertura em bits (modo varredura em instancias com incidencia_bits)
+    std::vector<char> ja_processado;      //ja_processado[j] != 0 se o subconjunto j ja foi selecionado
+    std::vector<double> penalidade_conf;  //penalidade de conflito de j com os ja selecionados
+    std::vector<int32_t> penalidade_conf_inteira; //o mesmo, nas variantes de custo inteiro
+    std::vector<int> novos;               //elementos ainda descobertos de j (modo fila de prioridade)
+    std::vector<std::pair<float, int>> gene_prioridades;
+    std::vector<EntradaHeap> heap_lcr;
+    std::vector<EntradaHeap> heap_restante;
+
+    std::vector<int> selecionados;        //solucao da ultima decodificacao, na ordem de selecao
+    bool empate_fora_lcr = false;         //alguma escolha fora da LCR foi desempatada pela posicao na lista
+    bool acerto_cache = false;            //o custo veio do cache (selecionados fica vazio)
+    bool usou_fora_lcr = false;           //a LCR se esgotou e a busca continuou no restante da lista
+
+    void preparar(const SCPCSInstance& instancia);
+};
+
+//tamanho da LCR do decodificador para n subconjuntos
+int tamanho_lcr(int n);
+
+double decodificar(Intervalo<float> genes, const SCPCSInstance& instancia, ContextoDecodificador& ctx,
+                   ModoDecodificador modo = DECODIFICADOR_VARREDURA, CacheFitness* cache = nullptr);
+double decodificar(Intervalo<float> genes, const SCPCSInstance& instancia, std::set<int>* solucao_saida = nullptr,
+                   ModoDecodificador modo = DECODIFICADOR_VARREDURA);
 double calcular_custo_solucao(const std::set<int>& subconjuntos_selecionados, const SCPCSInstance& instancia);
 #endif // DECODIFICADOR_HPP
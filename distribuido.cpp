@@ -0,0 +1,410 @@
+#include "distribuido.hpp"
+#include "transporte.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Migrantes recebidos e ainda nao importados: a thread de recepcao so guarda as cargas
+// e a thread da ilha as decodifica quando for a vez de migrar
+struct CaixaEntrada {
+    std::mutex mutex;
+    vector<vector<char>> cargas;
+};
+
+//carga de MENSAGEM_MIGRANTES: origem, num_genes, quantidade, fitness, refinado e genes
+static void escrever_migrantes(int origem, const Migrantes& migrantes, vector<char>& carga) {
+    carga.clear();
+    EscritorCarga escritor{carga};
+    escritor.escrever<int32_t>(origem);
+    escritor.escrever<int32_t>(migrantes.num_genes);
+    escritor.escrever<int32_t>(migrantes.quantidade());
+    escritor.escrever_bytes(migrantes.fitness.data(), migrantes.fitness.size() * sizeof(double));
+    escritor.escrever_bytes(migrantes.refinado.data(), migrantes.refinado.size());
+    escritor.escrever_bytes(migrantes.genes.data(), migrantes.genes.size() * sizeof(float));
+}
+
+static bool ler_migrantes(const vector<char>& carga, int num_genes_esperado, Migrantes& migrantes) {
+    LeitorCarga leitor{carga};
+    int32_t origem, num_genes, quantidade;
+    if (!leitor.ler(origem) || !leitor.ler(num_genes) || !leitor.ler(quantidade)) return false;
+    if (num_genes != num_genes_esperado || quantidade < 0) return false; //processo com outra instancia
+    if ((size_t)quantidade > leitor.restante() / (sizeof(double) + 1 + (size_t)num_genes * sizeof(float))) return false;
+    migrantes.num_genes = num_genes;
+    migrantes.fitness.resize(quantidade);
+    migrantes.refinado.resize(quantidade);
+    migrantes.genes.resize((size_t)quantidade * num_genes);
+    return leitor.ler_bytes(migrantes.fitness.data(), migrantes.fitness.size() * sizeof(double)) &&
+           leitor.ler_bytes(migrantes.refinado.data(), migrantes.refinado.size()) &&
+           leitor.ler_bytes(migrantes.genes.data(), migrantes.genes.size() * sizeof(float));
+}
+
+//carga de MENSAGEM_SOLUCAO: custos, tempos, contadores (busca local e cache), solucao, curva de convergencia
+//e rastreamento da ilha
+static void escrever_resultado(const ResultadoBRKGA& r, vector<char>& carga) {
+    EscritorCarga escritor{carga};
+    escritor.escrever(r.custo_antes_busca_local);
+    escritor.escrever(r.custo);
+    escritor.escrever(r.tempo_s);
+    escritor.escrever(r.tempo_melhor_s);
+    escritor.escrever(r.geracao_melhor);
+    escritor.escrever(r.tempo_alvo_s);
+    escritor.escrever(r.tempo_reproducao_s);
+    escritor.escrever(r.tempo_avaliacao_s);
+    escritor.escrever(r.tempo_ordenacao_s);
+    escritor.escrever(r.tempo_busca_local_s);
+    escritor.escrever(r.buscas_locais);
+    escritor.escrever(r.buscas_com_melhoria);
+    escritor.escrever(r.decodificacoes);
+    escritor.escrever(r.acertos_cache);
+    escritor.escrever(r.tempo_economizado_cache_s);
+    escritor.escrever<int32_t>((int32_t)r.solucao.size());
+    for (int j : r.solucao) escritor.escrever<int32_t>(j);
+    escritor.escrever<int32_t>((int32_t)r.convergencia.size());
+    for (const PontoConvergencia& ponto : r.convergencia) {
+        escritor.escrever(ponto.ilha);
+        escritor.escrever(ponto.geracao);
+        escritor.escrever(ponto.tempo_s);
+        escritor.escrever(ponto.melhor);
+    }
+    escritor.escrever<int32_t>((int32_t)r.rastro.size());
+    for (const RegistroGeracao& registro : r.rastro) {
+        escritor.escrever(registro.ilha);
+        escritor.escrever(registro.geracao);
+        escritor.escrever(registro.tempo_s);
+        escritor.escrever(registro.melhor);
+        escritor.escrever(registro.tempo_reproducao_s);
+        escritor.escrever(registro.tempo_mutantes_s);
+        escritor.escrever(registro.tempo_crossover_s);
+        escritor.escrever(registro.tempo_avaliacao_s);
+        escritor.escrever<int32_t>((int32_t)registro.avaliacao_ocupado_s.size());
+        escritor.escrever_bytes(registro.avaliacao_ocupado_s.data(), registro.avaliacao_ocupado_s.size() * sizeof(double));
+        escritor.escrever(registro.tempo_ordenacao_s);
+        escritor.escrever(registro.tempo_busca_local_s);
+        escritor.escrever(registro.decodificacoes);
+        escritor.escrever(registro.acertos_cache);
+        escritor.escrever(registro.tempo_economizado_cache_s);
+        escritor.escrever(registro.iteracoes_gulosas);
+        escritor.escrever(registro.usos_fora_lcr);
+        escritor.escrever(registro.reinicios);
+    }
+}
+
+//bytes gravados por escrever_resultado para cada ponto de convergencia e, no minimo (sem os tempos das threads),
+//para cada registro do rastreamento
+static const size_t TAMANHO_PONTO = sizeof(PontoConvergencia::ilha) + sizeof(PontoConvergencia::geracao) +
+                                    sizeof(PontoConvergencia::tempo_s) + sizeof(PontoConvergencia::melhor);
+static const size_t TAMANHO_REGISTRO_MINIMO =
+    sizeof(RegistroGeracao::ilha) + sizeof(RegistroGeracao::geracao) + sizeof(RegistroGeracao::tempo_s) +
+    sizeof(RegistroGeracao::melhor) + sizeof(RegistroGeracao::tempo_reproducao_s) + sizeof(RegistroGeracao::tempo_mutantes_s) +
+    sizeof(RegistroGeracao::tempo_crossover_s) + sizeof(RegistroGeracao::tempo_avaliacao_s) + sizeof(int32_t) +
+    sizeof(RegistroGeracao::tempo_ordenacao_s) + sizeof(RegistroGeracao::tempo_busca_local_s) +
+    sizeof(RegistroGeracao::decodificacoes) + sizeof(RegistroGeracao::acertos_cache) + sizeof(RegistroGeracao::tempo_economizado_cache_s) +
+    sizeof(RegistroGeracao::iteracoes_gulosas) + sizeof(RegistroGeracao::usos_fora_lcr) + sizeof(RegistroGeracao::reinicios);
+
+//um tamanho lido da carga so é aceito se os seus elementos cabem no que resta dela
+//(uma carga corrompida nao pode pedir uma alocacao arbitraria)
+static bool tamanho_valido(int32_t tamanho, const LeitorCarga& leitor, size_t bytes_por_elemento) {
+    return tamanho >= 0 && (size_t)tamanho <= leitor.restante() / bytes_por_elemento;
+}
+
+static bool ler_resultado(const vector<char>& carga, ResultadoBRKGA& r) {
+    LeitorCarga leitor{carga};
+    int32_t tamanho;
+    if (!leitor.ler(r.custo_antes_busca_local) || !leitor.ler(r.custo) || !leitor.ler(r.tempo_s) ||
+        !leitor.ler(r.tempo_melhor_s) || !leitor.ler(r.geracao_melhor) || !leitor.ler(r.tempo_alvo_s) ||
+        !leitor.ler(r.tempo_reproducao_s) || !leitor.ler(r.tempo_avaliacao_s) || !leitor.ler(r.tempo_ordenacao_s) ||
+        !leitor.ler(r.tempo_busca_local_s) || !leitor.ler(r.buscas_locais) || !leitor.ler(r.buscas_com_melhoria) ||
+        !leitor.ler(r.decodificacoes) || !leitor.ler(r.acertos_cache) || !leitor.ler(r.tempo_economizado_cache_s) ||
+        !leitor.ler(tamanho)) {
+        return false;
+    }
+    if (!tamanho_valido(tamanho, leitor, sizeof(int32_t))) return false;
+    for (int32_t i = 0; i < tamanho; i++) {
+        int32_t j;
+        if (!leitor.ler(j)) return false;
+        r.solucao.insert(r.solucao.end(), j);
+    }
+    if (!leitor.ler(tamanho) || !tamanho_valido(tamanho, leitor, TAMANHO_PONTO)) return false;
+    r.convergencia.resize(tamanho);
+    for (PontoConvergencia& ponto : r.convergencia) {
+        if (!leitor.ler(ponto.ilha) || !leitor.ler(ponto.geracao) || !leitor.ler(ponto.tempo_s) || !leitor.ler(ponto.melhor)) {
+            return false;
+        }
+    }
+    if (!leitor.ler(tamanho) || !tamanho_valido(tamanho, leitor, TAMANHO_REGISTRO_MINIMO)) return false;
+    r.rastro.resize(tamanho);
+    for (RegistroGeracao& registro : r.rastro) {
+        int32_t num_threads;
+        if (!leitor.ler(registro.ilha) || !leitor.ler(registro.geracao) || !leitor.ler(registro.tempo_s) ||
+            !leitor.ler(registro.melhor) || !leitor.ler(registro.tempo_reproducao_s) || !leitor.ler(registro.tempo_mutantes_s) ||
+            !leitor.ler(registro.tempo_crossover_s) || !leitor.ler(registro.tempo_avaliacao_s) || !leitor.ler(num_threads) ||
+            !tamanho_valido(num_threads, leitor, sizeof(double))) {
+            return false;
+        }
+        registro.avaliacao_ocupado_s.resize(num_threads);
+        if (!leitor.ler_bytes(registro.avaliacao_ocupado_s.data(), num_threads * sizeof(double)) ||
+            !leitor.ler(registro.tempo_ordenacao_s) || !leitor.ler(registro.tempo_busca_local_s) ||
+            !leitor.ler(registro.decodificacoes) || !leitor.ler(registro.acertos_cache) ||
+            !leitor.ler(registro.tempo_economizado_cache_s) || !leitor.ler(registro.iteracoes_gulosas) ||
+            !leitor.ler(registro.usos_fora_lcr) || !leitor.ler(registro.reinicios)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//tudo o que precisa ser igual em todos os processos: a instancia, os parametros do BRKGA e os da migracao;
+//a semente e o numero de processos nao entram (o coordenador envia os seus no MENSAGEM_OLA)
+static string descrever_configuracao(const SCPCSInstance& instancia, const ParametrosBRKGA& p,
+                                     const ParametrosDistribuido& parametros_distribuido) {
+    const ParametrosIlhas& migracao = parametros_distribuido.migracao;
+    std::ostringstream texto;
+    texto.precision(17);
+    texto << "subconjuntos=" << instancia.num_subconjuntos << ";elementos=" << instancia.num_elementos
+          << ";populacao=" << p.tamanho_populacao << ";elite=" << p.tamanho_elite << ";geracoes=" << p.num_geracoes
+          << ";mutantes=" << p.percentual_mutantes << ";decodificador=" << p.modo_decodificador
+          << ";alvo=" << p.custo_alvo << ";parar_no_alvo=" << p.parar_no_alvo
+          << ";bl_elite=" << p.busca_local_elite << ";bl_intervalo=" << p.intervalo_busca_local
+          << ";bl_tempo_ms=" << p.tempo_busca_local_ms << ";bl_movimentos=" << p.movimentos_busca_local
+          << ";bl_recodificar=" << p.recodificar_busca_local << ";cache=" << p.tamanho_cache_fitness
+          << ";tempo_limite=" << p.tempo_limite_s << ";estagnacao=" << p.max_geracoes_sem_melhoria
+          << ";diversidade_min=" << p.diversidade_minima << ";migracao=" << migracao.intervalo_migracao
+          << ";migrantes=" << migracao.num_migrantes << ";topologia=" << migracao.topologia;
+    return texto.str();
+}
+
+//imprime os campos "nome=valor" que diferem entre as configuracoes do coordenador e do trabalhador
+static void imprimir_diferencas(const string& coordenador, const string& trabalhador) {
+    auto campos = [](const string& texto) {
+        vector<string> lista;
+        std::istringstream entrada(texto);
+        string campo;
+        while (std::getline(entrada, campo, ';')) lista.push_back(campo);
+        return lista;
+    };
+    vector<string> esperados = campos(coordenador), recebidos = campos(trabalhador);
+    for (size_t i = 0; i < std::max(esperados.size(), recebidos.size()); i++) {
+        string esperado = i < esperados.size() ? esperados[i] : "", recebido = i < recebidos.size() ? recebidos[i] : "";
+        if (esperado != recebido) cerr << "  coordenador " << esperado << ", trabalhador " << recebido << endl;
+    }
+}
+
+//destinos[p] = processos que recebem os migrantes do processo p (o inverso de origens_da_ilha)
+static vector<vector<int>> tabela_destinos(const ParametrosDistribuido& parametros_distribuido) {
+    ParametrosIlhas topologia = parametros_distribuido.migracao;
+    topologia.num_ilhas = parametros_distribuido.num_processos;
+    vector<vector<int>> destinos(topologia.num_ilhas);
+    for (int processo = 0; processo < topologia.num_ilhas; processo++) {
+        for (int origem : origens_da_ilha(processo, topologia)) destinos[origem].push_back(processo);
+    }
+    return destinos;
+}
+
+//evolui a ilha do processo ate um criterio de parada do motor ou o pedido de parada; a cada intervalo de migracao,
+//publica os melhores individuos e importa tudo o que chegou desde a migracao anterior
+template <typename Publicar>
+static void evoluir_ilha(MotorBRKGA& motor, int processo, int num_genes, const ParametrosDistribuido& parametros_distribuido,
+                         const std::atomic<bool>& parar,
+                         CaixaEntrada& caixa, Publicar publicar) {
+    const ParametrosIlhas& migracao = parametros_distribuido.migracao;
+    bool migrar = parametros_distribuido.num_processos > 1 && migracao.intervalo_migracao > 0 && migracao.num_migrantes > 0;
+    Migrantes envio, recebidos;
+    vector<char> carga;
+    vector<vector<char>> pendentes;
+
+    motor.inicializar();
+    while (!motor.terminou() && !parar.load(std::memory_order_relaxed)) {
+        motor.evoluir_geracao();
+        if (!migrar || motor.geracao() % migracao.intervalo_migracao != 0) continue;
+
+        motor.exportar_melhores(migracao.num_migrantes, envio);
+        escrever_migrantes(processo, envio, carga);
+        publicar(carga);
+        {
+            std::lock_guard<std::mutex> trava(caixa.mutex);
+            std::swap(pendentes, caixa.cargas);
+        }
+        for (const vector<char>& recebida : pendentes) {
+            if (ler_migrantes(recebida, num_genes, recebidos)) motor.importar(recebidos);
+        }
+        pendentes.clear();
+    }
+}
+
+static bool executar_coordenador(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros,
+                                 const ParametrosDistribuido& parametros_distribuido, PoolThreads& pool, ResultadoBRKGA& resultado) {
+    int num_processos = std::max(1, parametros_distribuido.num_processos);
+    ServidorCanais servidor;
+    vector<unique_ptr<Canal>> canais(num_processos); //canais[0] fica vazio (o proprio coordenador)
+    if (num_processos > 1) {
+        if (!servidor.escutar(parametros_distribuido.endereco)) return false;
+        cout << "Aguardando " << num_processos - 1 << " trabalhadores em " << parametros_distribuido.endereco << endl;
+        //o prazo vale para todos os trabalhadores juntos, incluindo a configuracao que cada um envia ao conectar
+        string esperada = descrever_configuracao(instancia, parametros, parametros_distribuido);
+        auto limite = std::chrono::steady_clock::now() + std::chrono::duration<double>(parametros_distribuido.espera_trabalhadores_s);
+        auto restante = [&]() { return std::chrono::duration<double>(limite - std::chrono::steady_clock::now()).count(); };
+        for (int processo = 1; processo < num_processos; processo++) {
+            canais[processo] = servidor.aceitar(restante());
+            if (!canais[processo]) {
+                cerr << "Erro ao aceitar a conexao do trabalhador " << processo << " (" << processo - 1 << " de "
+                     << num_processos - 1 << " conectados em " << parametros_distribuido.espera_trabalhadores_s << " s)" << endl;
+                return false;
+            }
+            Mensagem mensagem;
+            if (!canais[processo]->receber(mensagem, restante()) || mensagem.tipo != MENSAGEM_OLA) {
+                cerr << "O trabalhador " << processo << " nao enviou a sua configuracao" << endl;
+                return false;
+            }
+            string recebida(mensagem.carga.begin(), mensagem.carga.end());
+            if (recebida != esperada) {
+                cerr << "O trabalhador " << processo << " usa outra configuracao (execucao cancelada):" << endl;
+                imprimir_diferencas(esperada, recebida);
+                return false;
+            }
+        }
+    }
+
+    //numero do processo, total de processos e semente da execucao; so depois que todos conectaram,
+    //entao a mensagem tambem libera os trabalhadores para comecar juntos
+    for (int processo = 1; processo < num_processos; processo++) {
+        vector<char> carga;
+        EscritorCarga escritor{carga};
+        escritor.escrever<int32_t>(processo);
+        escritor.escrever<int32_t>(num_processos);
+        escritor.escrever<uint64_t>(parametros.semente);
+        canais[processo]->enviar(MENSAGEM_OLA, carga);
+    }
+    auto inicio = std::chrono::steady_clock::now();
+
+    vector<vector<int>> destinos = tabela_destinos(parametros_distribuido);
+    CaixaEntrada caixa;
+    std::atomic<bool> parar{false}; //o coordenador para pelos criterios do proprio motor
+    vector<ResultadoBRKGA> resultados(num_processos);
+    vector<char> recebido(num_processos, 0);
+
+    //repassa os migrantes de "origem" aos processos de destino da topologia
+    //(o envio a um trabalhador que ja terminou falha e é ignorado)
+    auto entregar = [&](int origem, const vector<char>& carga) {
+        for (int destino : destinos[origem]) {
+            if (destino == 0) {
+                std::lock_guard<std::mutex> trava(caixa.mutex);
+                caixa.cargas.push_back(carga);
+            } else {
+                canais[destino]->enviar(MENSAGEM_MIGRANTES, carga);
+            }
+        }
+    };
+
+    //uma thread de recepcao por trabalhador, ate o trabalhador fechar a conexao depois de enviar a solucao
+    vector<std::thread> receptores;
+    for (int processo = 1; processo < num_processos; processo++) {
+        receptores.emplace_back([&, processo]() {
+            Mensagem mensagem;
+            while (canais[processo]->receber(mensagem)) {
+                if (mensagem.tipo == MENSAGEM_MIGRANTES) {
+                    entregar(processo, mensagem.carga);
+                } else if (mensagem.tipo == MENSAGEM_SOLUCAO) {
+                    recebido[processo] = ler_resultado(mensagem.carga, resultados[processo]);
+                }
+            }
+        });
+    }
+
+    ParametrosBRKGA parametros_ilha = parametros;
+    parametros_ilha.semente = semente_da_ilha(parametros.semente, 0);
+    MotorBRKGA motor(instancia, parametros_ilha, pool, 0);
+    evoluir_ilha(motor, 0, instancia.num_subconjuntos, parametros_distribuido, parar, caixa,
+                 [&](const vector<char>& carga) { entregar(0, carga); });
+
+    //fim da evolucao global: os trabalhadores fazem a busca local final ao mesmo tempo que o coordenador
+    for (int processo = 1; processo < num_processos; processo++) {
+        canais[processo]->enviar(MENSAGEM_PARAR, {});
+    }
+    resultados[0] = motor.finalizar();
+    recebido[0] = 1;
+    for (auto& receptor : receptores) {
+        receptor.join();
+    }
+
+    vector<ResultadoBRKGA> validos;
+    for (int processo = 0; processo < num_processos; processo++) {
+        if (!recebido[processo]) {
+            cerr << "O processo " << processo << " nao enviou a sua solucao" << endl;
+            continue;
+        }
+        cout << "processo " << processo << ": custo " << resultados[processo].custo
+             << " (melhor na geracao " << resultados[processo].geracao_melhor << ")" << endl;
+        validos.push_back(std::move(resultados[processo]));
+    }
+    resultado = combinar_resultados_ilhas(validos);
+    resultado.tempo_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    return true;
+}
+
+static bool executar_trabalhador(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros,
+                                 const ParametrosDistribuido& parametros_distribuido, PoolThreads& pool, ResultadoBRKGA& resultado) {
+    unique_ptr<Canal> canal = conectar_canal(parametros_distribuido.endereco, parametros_distribuido.espera_conexao_s);
+    if (!canal) return false;
+    string configuracao = descrever_configuracao(instancia, parametros, parametros_distribuido);
+    if (!canal->enviar(MENSAGEM_OLA, vector<char>(configuracao.begin(), configuracao.end()))) return false;
+
+    Mensagem mensagem;
+    int32_t processo = 0, num_processos = 0;
+    uint64_t semente = 0;
+    LeitorCarga leitor{mensagem.carga};
+    if (!canal->receber(mensagem) || mensagem.tipo != MENSAGEM_OLA ||
+        !leitor.ler(processo) || !leitor.ler(num_processos) || !leitor.ler(semente)) {
+        cerr << "O coordenador nao iniciou a execucao (a instancia e os parametros devem ser os mesmos do coordenador)" << endl;
+        return false;
+    }
+    cout << "Trabalhador " << processo << " de " << num_processos << " conectado a " << parametros_distribuido.endereco << endl;
+    ParametrosDistribuido parametros_processo = parametros_distribuido;
+    parametros_processo.num_processos = num_processos;
+
+    //a recepcao roda ate o coordenador fechar a conexao; o fim da conexao tambem encerra a evolucao
+    CaixaEntrada caixa;
+    std::atomic<bool> parar{false};
+    std::thread receptor([&]() {
+        Mensagem recebida;
+        while (canal->receber(recebida)) {
+            if (recebida.tipo == MENSAGEM_MIGRANTES) {
+                std::lock_guard<std::mutex> trava(caixa.mutex);
+                caixa.cargas.push_back(std::move(recebida.carga));
+            } else if (recebida.tipo == MENSAGEM_PARAR) {
+                parar.store(true);
+            }
+        }
+        parar.store(true);
+    });
+
+    ParametrosBRKGA parametros_ilha = parametros;
+    parametros_ilha.semente = semente_da_ilha(semente, processo);
+    MotorBRKGA motor(instancia, parametros_ilha, pool, processo);
+    evoluir_ilha(motor, processo, instancia.num_subconjuntos, parametros_processo, parar, caixa,
+                 [&](const vector<char>& carga) { canal->enviar(MENSAGEM_MIGRANTES, carga); });
+    resultado = motor.finalizar();
+
+    vector<char> carga;
+    escrever_resultado(resultado, carga);
+    canal->enviar(MENSAGEM_SOLUCAO, carga);
+    canal->encerrar_envio();
+    receptor.join();
+    return true;
+}
+
+bool brkga_distribuido(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros,
+                       const ParametrosDistribuido& parametros_distribuido, PoolThreads& pool, ResultadoBRKGA& resultado) {
+    if (parametros_distribuido.papel == PAPEL_TRABALHADOR) {
+        return executar_trabalhador(instancia, parametros, parametros_distribuido, pool, resultado);
+    }
+    return executar_coordenador(instancia, parametros, parametros_distribuido, pool, resultado);
+}
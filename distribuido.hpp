@@ -0,0 +1,40 @@
+#ifndef DISTRIBUIDO_HPP
+#define DISTRIBUIDO_HPP
+
+#include "brkga.hpp"
+#include "ilhas.hpp"
+#include <string>
+
+// Papel do processo no modo distribuido
+enum PapelDistribuido {
+    PAPEL_NENHUM,       //execucao local (sem processos remotos)
+    PAPEL_COORDENADOR,  //processo 0: aceita os trabalhadores, repassa os migrantes e junta as solucoes
+    PAPEL_TRABALHADOR   //processos 1..N-1: uma ilha cada, conectada ao coordenador
+};
+
+// Parametros do modelo de ilhas distribuido em processos
+struct ParametrosDistribuido {
+    PapelDistribuido papel = PAPEL_NENHUM;
+    std::string endereco = "unix:/tmp/brkga_scp.sock"; //ou "tcp:<host>:<porta>"
+    int num_processos = 2; //processos no total, incluindo o coordenador
+    double espera_conexao_s = 30.0; //tempo que o trabalhador espera o coordenador comecar a escutar
+    double espera_trabalhadores_s = 120.0; //tempo que o coordenador espera todos os trabalhadores conectarem
+    ParametrosIlhas migracao; //intervalo, numero de migrantes e topologia (num_ilhas é ignorado: uma ilha por processo)
+};
+
+// Executa uma ilha do BRKGA neste processo, trocando migrantes com as ilhas dos outros processos.
+// O coordenador (processo 0) aceita os num_processos - 1 trabalhadores, confere que cada um usa a mesma instancia
+// e os mesmos parametros (exceto a semente e o numero de processos, que vem do coordenador) e envia a cada um
+// o seu numero e a semente;
+// todos os migrantes passam por ele, que os repassa de acordo com a topologia (estrela de conexoes, entao
+// os trabalhadores nao precisam conhecer os enderecos uns dos outros). Quando a sua evolucao termina (por qualquer
+// criterio de parada de ParametrosBRKGA, como o tempo limite), o coordenador manda os trabalhadores pararem
+// e junta as melhores solucoes.
+// Todos os processos devem carregar a mesma instancia com os mesmos parametros.
+// Grava no coordenador o resultado combinado de todos os processos e no trabalhador o da sua ilha;
+// retorna false se a conexao entre os processos falhar, se os trabalhadores nao conectarem a tempo
+// ou se algum deles usar outra configuracao.
+bool brkga_distribuido(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros,
+                       const ParametrosDistribuido& parametros_distribuido, PoolThreads& pool, ResultadoBRKGA& resultado);
+
+#endif // DISTRIBUIDO_HPP
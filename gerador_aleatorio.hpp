@@ -0,0 +1,45 @@
+#ifndef GERADOR_ALEATORIO_HPP
+#define GERADOR_ALEATORIO_HPP
+
+#include <cstdint>
+
+// Gerador aleatorio baseado em contador (no estilo do Philox): o k-esimo numero de um fluxo é uma funcao
+// pura de (semente, id do fluxo, k), calculada por uma funcao de mistura (finalizador do SplitMix64).
+// Nao ha estado compartilhado, entao cada individuo pode ter o seu proprio fluxo e ser gerado por
+// qualquer thread, em qualquer ordem, com o mesmo resultado; e como cada numero depende so do contador,
+// lacos que geram blocos de numeros nao tem dependencia entre iteracoes e podem ser vetorizados.
+struct FluxoAleatorio {
+    uint64_t chave;
+
+    static constexpr uint64_t PHI = 0x9E3779B97F4A7C15ULL; //incremento de Weyl (razao aurea)
+
+    static uint64_t misturar(uint64_t x) {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    FluxoAleatorio(uint64_t semente, uint64_t id_fluxo)
+        : chave(misturar(semente + PHI) ^ misturar(id_fluxo * PHI + 0x632BE59BD9B4E019ULL)) {}
+
+    //64 bits aleatorios da posicao "contador" do fluxo
+    uint64_t bits(uint64_t contador) const { return misturar(chave + contador * PHI); }
+
+    //float uniforme em [0, 1) com 24 bits de precisao
+    float uniforme(uint64_t contador) const { return (float)(bits(contador) >> 40) * (1.0f / 16777216.0f); }
+
+    //float uniforme em [minimo, maximo)
+    float uniforme(uint64_t contador, float minimo, float maximo) const {
+        return minimo + (maximo - minimo) * uniforme(contador);
+    }
+
+    //inteiro uniforme em [0, max_exclusive) (multiplicacao de 32 x 32 bits, sem divisao)
+    int indice(uint64_t contador, int max_exclusive) const {
+        return (int)(((bits(contador) >> 32) * (uint64_t)max_exclusive) >> 32);
+    }
+};
+
+#endif // GERADOR_ALEATORIO_HPP
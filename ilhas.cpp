@@ -0,0 +1,132 @@
+#include "ilhas.hpp"
+#include "gerador_aleatorio.hpp"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Caixa de migracao de uma ilha: so a dona escreve (a cada migracao) e so as ilhas vizinhas leem,
+// entao a disputa pelo mutex é pequena; versao permite que cada leitora copie cada publicacao uma unica vez
+struct CaixaMigracao {
+    std::mutex mutex;
+    Migrantes migrantes;
+    long long versao = 0;
+};
+
+uint64_t semente_da_ilha(uint64_t semente, int ilha) {
+    return ilha == 0 ? semente : FluxoAleatorio(semente, (uint64_t)ilha).bits(0);
+}
+
+vector<int> origens_da_ilha(int ilha, const ParametrosIlhas& parametros_ilhas) {
+    int num_ilhas = parametros_ilhas.num_ilhas;
+    vector<int> origens;
+    if (num_ilhas <= 1) return origens;
+    if (parametros_ilhas.topologia == TOPOLOGIA_ANEL) {
+        origens.push_back((ilha + num_ilhas - 1) % num_ilhas);
+        return origens;
+    }
+    for (int outra = 0; outra < num_ilhas; outra++) {
+        if (outra != ilha) origens.push_back(outra);
+    }
+    return origens;
+}
+
+ResultadoBRKGA combinar_resultados_ilhas(const vector<ResultadoBRKGA>& resultados) {
+    int melhor_ilha = 0;
+    for (int ilha = 1; ilha < (int)resultados.size(); ilha++) {
+        if (resultados[ilha].custo < resultados[melhor_ilha].custo) melhor_ilha = ilha;
+    }
+    ResultadoBRKGA resultado = resultados[melhor_ilha];
+    resultado.tempo_reproducao_s = resultado.tempo_avaliacao_s = resultado.tempo_ordenacao_s = resultado.tempo_busca_local_s = 0.0;
+    resultado.buscas_locais = resultado.buscas_com_melhoria = 0;
+    resultado.decodificacoes = resultado.acertos_cache = 0;
+    resultado.tempo_economizado_cache_s = 0.0;
+    resultado.convergencia.clear();
+    resultado.rastro.clear();
+    for (const ResultadoBRKGA& r : resultados) {
+        resultado.tempo_reproducao_s += r.tempo_reproducao_s;
+        resultado.tempo_avaliacao_s += r.tempo_avaliacao_s;
+        resultado.tempo_ordenacao_s += r.tempo_ordenacao_s;
+        resultado.tempo_busca_local_s += r.tempo_busca_local_s;
+        resultado.buscas_locais += r.buscas_locais;
+        resultado.buscas_com_melhoria += r.buscas_com_melhoria;
+        resultado.decodificacoes += r.decodificacoes;
+        resultado.acertos_cache += r.acertos_cache;
+        resultado.tempo_economizado_cache_s += r.tempo_economizado_cache_s;
+        if (r.tempo_alvo_s >= 0 && (resultado.tempo_alvo_s < 0 || r.tempo_alvo_s < resultado.tempo_alvo_s)) {
+            resultado.tempo_alvo_s = r.tempo_alvo_s;
+        }
+        resultado.convergencia.insert(resultado.convergencia.end(), r.convergencia.begin(), r.convergencia.end());
+        resultado.rastro.insert(resultado.rastro.end(), r.rastro.begin(), r.rastro.end());
+    }
+    return resultado;
+}
+
+ResultadoBRKGA brkga_ilhas(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros,
+                           const ParametrosIlhas& parametros_ilhas, int num_threads) {
+    int num_ilhas = std::max(1, parametros_ilhas.num_ilhas);
+    int threads_por_ilha = std::max(1, num_threads / num_ilhas);
+    auto inicio = std::chrono::steady_clock::now();
+
+    vector<unique_ptr<CaixaMigracao>> caixas;
+    vector<ResultadoBRKGA> resultados(num_ilhas);
+    for (int ilha = 0; ilha < num_ilhas; ilha++) {
+        caixas.emplace_back(new CaixaMigracao());
+    }
+
+    auto executar_ilha = [&](int ilha) {
+        ParametrosBRKGA parametros_ilha = parametros;
+        parametros_ilha.semente = semente_da_ilha(parametros.semente, ilha);
+        PoolThreads pool(threads_por_ilha);
+        MotorBRKGA motor(instancia, parametros_ilha, pool, ilha);
+
+        vector<int> origens = origens_da_ilha(ilha, parametros_ilhas);
+        vector<long long> versoes_lidas(origens.size(), 0);
+        Migrantes envio, recebidos;
+        bool migrar = !origens.empty() && parametros_ilhas.intervalo_migracao > 0 && parametros_ilhas.num_migrantes > 0;
+
+        motor.inicializar();
+        while (!motor.terminou()) {
+            motor.evoluir_geracao();
+            if (!migrar || motor.geracao() % parametros_ilhas.intervalo_migracao != 0) continue;
+
+            //publica os melhores (troca de buffers dentro da caixa, sem copiar os genes com o mutex travado)
+            motor.exportar_melhores(parametros_ilhas.num_migrantes, envio);
+            {
+                std::lock_guard<std::mutex> trava(caixas[ilha]->mutex);
+                std::swap(caixas[ilha]->migrantes, envio);
+                caixas[ilha]->versao++;
+            }
+            //recebe somente as publicacoes ainda nao lidas de cada origem
+            for (size_t o = 0; o < origens.size(); o++) {
+                CaixaMigracao& caixa = *caixas[origens[o]];
+                {
+                    std::lock_guard<std::mutex> trava(caixa.mutex);
+                    if (caixa.versao == versoes_lidas[o]) continue;
+                    versoes_lidas[o] = caixa.versao;
+                    recebidos = caixa.migrantes;
+                }
+                motor.importar(recebidos);
+            }
+        }
+        resultados[ilha] = motor.finalizar();
+    };
+
+    //a ilha 0 roda na thread que chamou a funcao
+    vector<std::thread> threads_ilhas;
+    for (int ilha = 1; ilha < num_ilhas; ilha++) {
+        threads_ilhas.emplace_back(executar_ilha, ilha);
+    }
+    executar_ilha(0);
+    for (auto& thread_ilha : threads_ilhas) {
+        thread_ilha.join();
+    }
+
+    ResultadoBRKGA resultado = combinar_resultados_ilhas(resultados);
+    resultado.tempo_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    return resultado;
+}
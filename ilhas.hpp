@@ -0,0 +1,40 @@
+#ifndef ILHAS_HPP
+#define ILHAS_HPP
+
+#include "brkga.hpp"
+#include <vector>
+
+// Topologia de migracao: de quais ilhas cada ilha recebe os migrantes
+enum TopologiaMigracao {
+    TOPOLOGIA_ANEL,   //a ilha i recebe da ilha i - 1
+    TOPOLOGIA_TODOS   //a ilha i recebe de todas as outras
+};
+
+// Parametros do modelo de ilhas
+struct ParametrosIlhas {
+    int num_ilhas = 1; //populacoes independentes (1 = BRKGA com uma unica populacao)
+    int intervalo_migracao = 10; //geracoes entre duas migracoes
+    int num_migrantes = 2; //melhores individuos enviados por ilha em cada migracao
+    TopologiaMigracao topologia = TOPOLOGIA_ANEL;
+};
+
+// Semente da ilha: a ilha 0 usa a semente da execucao (uma ilha = BRKGA com uma populacao)
+uint64_t semente_da_ilha(uint64_t semente, int ilha);
+
+// Ilhas das quais a ilha recebe os migrantes na topologia (vazio com uma unica ilha)
+std::vector<int> origens_da_ilha(int ilha, const ParametrosIlhas& parametros_ilhas);
+
+// Resultado da melhor ilha, com os tempos de etapa somados, o primeiro instante em que o alvo foi atingido
+// e as curvas de convergencia e o rastreamento de todas as ilhas (tempo_s fica o da melhor ilha)
+ResultadoBRKGA combinar_resultados_ilhas(const std::vector<ResultadoBRKGA>& resultados);
+
+// Executa o BRKGA no modelo de ilhas: cada ilha evolui a sua populacao (com parametros, exceto a semente)
+// na sua propria thread e com o seu proprio pool de avaliacao, dividindo as num_threads threads entre as ilhas.
+// A cada intervalo_migracao geracoes, cada ilha publica os seus melhores individuos na sua caixa de migracao
+// e copia os das caixas das ilhas de origem da topologia; a troca é assincrona (nenhuma ilha espera as outras),
+// entao o resultado com mais de uma ilha depende do ritmo das threads.
+// O resultado é o da melhor ilha, com os tempos de etapa somados e as curvas de convergencia de todas as ilhas.
+ResultadoBRKGA brkga_ilhas(const SCPCSInstance& instancia, const ParametrosBRKGA& parametros,
+                           const ParametrosIlhas& parametros_ilhas, int num_threads);
+
+#endif // ILHAS_HPP
@@ -0,0 +1,825 @@
+#include "brkga.hpp"
+#include "ilhas.hpp"
+#include "distribuido.hpp"
+#include "assincrono.hpp"
+#include "reducao.hpp"
+#include "decodificador.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+
+// Executor de experimentos: roda o BRKGA em lote para todas as combinacoes de instancias, valores de k,
+// parametros e sementes, distribuindo as execucoes independentes entre os nucleos.
+// Cada instancia é carregada uma unica vez por k e compartilhada (somente leitura) entre as execucoes.
+
+using namespace std;
+
+// Opcoes da linha de comando (sem argumentos, reproduz a configuracao original: scpclr10, k = 1, 5 execucoes)
+struct OpcoesExecucao {
+    vector<string> padroes_instancias;
+    vector<int> valores_k;
+    vector<int> populacoes;
+    vector<int> elites;
+    vector<int> geracoes;
+    vector<float> mutantes;
+    vector<uint64_t> sementes;
+    int num_execucoes = 5; //execucoes por configuracao quando as sementes nao sao informadas
+    uint64_t semente_base = std::random_device{}(); //a execucao i usa semente_base + i
+    int num_threads = std::thread::hardware_concurrency(); //threads no total (0 = 1 thread)
+    ParametrosBRKGA base; //parametros fixos (decodificador e busca local), copiados para todas as execucoes
+    bool usar_cache_binario = false; //le/grava "<instancia>.k<k>.bin" com a instancia e os conflitos pre-calculados
+    bool reduzir = false; //fixa os subconjuntos obrigatorios e remove os dominados antes do BRKGA
+    bool assincrono = false; //motor em estado estacionario, sem barreira entre as geracoes
+    double alvo_padrao = -1.0; //custo alvo de todas as instancias (< 0 = sem alvo)
+    map<string, double> alvos; //custo alvo por nome de arquivo da instancia (ex: "scp41-3.txt")
+    string arquivo_csv; //tabela resumo (uma linha por instancia/k/configuracao)
+    string arquivo_csv_execucoes; //uma linha por execucao
+    string arquivo_json; //execucoes e resumo
+    string arquivo_curvas; //curvas de convergencia (um ponto por melhoria de cada ilha)
+    string arquivo_rastro; //rastreamento por geracao em JSON lines (requer -DBRKGA_RASTREAMENTO)
+    ParametrosIlhas ilhas; //modelo de ilhas (1 ilha = BRKGA com uma unica populacao)
+    ParametrosDistribuido distribuido; //ilhas em processos separados (uma unica execucao)
+};
+
+// Uma execucao do lote e o seu resultado
+struct Execucao {
+    string instancia;
+    int k = 0;
+    ParametrosBRKGA parametros;
+    ResultadoBRKGA resultado;
+};
+
+static void exibir_uso() {
+    cout << "uso: brkga [opcoes]\n"
+         << "  -i, --instancias P1,P2   arquivos ou padroes (* e ?) das instancias (padrao: instancias//scpclr10-3.txt)\n"
+         << "  -k, --k L                valores de k (padrao: 1)\n"
+         << "  -s, --sementes L         sementes das execucoes (padrao: aleatorias)\n"
+         << "  -r, --execucoes N        execucoes por configuracao quando --sementes nao é usado (padrao: 5)\n"
+         << "  -p, --populacao L        tamanhos da populacao (padrao: 140)\n"
+         << "  -e, --elite L            tamanhos da elite (padrao: 28)\n"
+         << "  -g, --geracoes L         numeros de geracoes (padrao: 500)\n"
+         << "  -m, --mutantes L         percentuais de mutantes (padrao: 0.2)\n"
+         << "  -t, --threads N          threads no total (padrao: todos os nucleos)\n"
+         << "  -d, --decodificador M    varredura ou fila (padrao: varredura)\n"
+         << "      --cache              usa o cache binario das instancias\n"
+         << "      --reducao            fixa os subconjuntos obrigatorios e remove os dominados antes do BRKGA\n"
+         << "      --cache-fitness N    entradas do cache de fitness indexado pela LCR (padrao: 65536, 0 desativa)\n"
+         << "      --tempo-limite S     para a evolucao depois de S segundos (padrao: sem limite)\n"
+         << "      --estagnacao G       para depois de G geracoes sem melhoria (padrao: sem limite)\n"
+         << "      --parar-no-alvo      para quando o custo alvo (--alvo/--alvos) for atingido\n"
+         << "      --diversidade-min D  reinicia a populacao (mantendo o melhor) se a diversidade da elite ficar abaixo de D, entre 0 e 1\n"
+         << "      --bl-elite E         refina os E melhores individuos com busca local durante a evolucao (padrao: 0)\n"
+         << "      --bl-intervalo G     executa a busca local a cada G geracoes (padrao: 1)\n"
+         << "      --bl-tempo-ms T      orcamento de tempo de cada etapa de busca local (padrao: sem limite)\n"
+         << "      --bl-movimentos M    orcamento de movimentos por individuo refinado (padrao: sem limite)\n"
+         << "      --bl-recodificar     reescreve os genes dos individuos refinados\n"
+         << "      --alvo X             custo alvo do tempo-ate-o-alvo para todas as instancias\n"
+         << "      --alvos ARQ          arquivo com linhas \"<instancia> <custo alvo>\"\n"
+         << "      --csv ARQ            grava a tabela resumo em CSV\n"
+         << "      --csv-execucoes ARQ  grava uma linha por execucao em CSV\n"
+         << "      --json ARQ           grava execucoes e resumo em JSON\n"
+         << "      --curvas ARQ         grava as curvas de convergencia de cada execucao e ilha em CSV\n"
+         << "      --rastro ARQ         grava uma linha JSON por geracao de cada execucao e ilha (compilado com -DBRKGA_RASTREAMENTO)\n"
+         << "      --assincrono         BRKGA em estado estacionario: as threads inserem cada individuo avaliado sem esperar as geracoes\n"
+         << "                           (sem --ilhas, --distribuido, --bl-*, --diversidade-min e --rastro)\n"
+         << "      --ilhas P            populacoes independentes por execucao, com migracao (padrao: 1)\n"
+         << "      --migracao M         geracoes entre migracoes (padrao: 10)\n"
+         << "      --migrantes K        melhores individuos enviados por ilha (padrao: 2)\n"
+         << "      --topologia T        anel ou todos (padrao: anel)\n"
+         << "      --distribuido P      coordenador ou trabalhador: uma ilha por processo, com migracao por sockets\n"
+         << "      --endereco E         unix:<caminho> ou tcp:<host>:<porta> (padrao: unix:/tmp/brkga_scp.sock)\n"
+         << "      --processos N        processos no total, incluindo o coordenador (padrao: 2)\n"
+         << "      --espera-trabalhadores S\n"
+         << "                           segundos que o coordenador espera os trabalhadores conectarem (padrao: 120)\n"
+         << "listas (L) sao separadas por virgula e aceitam intervalos inteiros, ex: 1,2,5-8\n";
+}
+
+//separa "a,b,c" em {"a", "b", "c"}
+static vector<string> separar(const string& texto, char separador) {
+    vector<string> partes;
+    string parte;
+    std::istringstream entrada(texto);
+    while (std::getline(entrada, parte, separador)) {
+        if (!parte.empty()) partes.push_back(parte);
+    }
+    return partes;
+}
+
+//lista de inteiros com intervalos: "1,3,5-8" -> {1, 3, 5, 6, 7, 8}
+template <typename T>
+static vector<T> ler_lista_inteiros(const string& texto) {
+    vector<T> valores;
+    for (const string& parte : separar(texto, ',')) {
+        size_t traco = parte.find('-', 1); //o primeiro caractere pode ser o sinal
+        if (traco == string::npos) {
+            valores.push_back((T)std::stoll(parte));
+            continue;
+        }
+        long long inicio = std::stoll(parte.substr(0, traco));
+        long long fim = std::stoll(parte.substr(traco + 1));
+        for (long long v = inicio; v <= fim; ++v) valores.push_back((T)v);
+    }
+    return valores;
+}
+
+static vector<float> ler_lista_reais(const string& texto) {
+    vector<float> valores;
+    for (const string& parte : separar(texto, ',')) valores.push_back(std::stof(parte));
+    return valores;
+}
+
+//compara um nome com um padrao que aceita '*' (qualquer sequencia) e '?' (um caractere)
+static bool casa_padrao(const char* padrao, const char* nome) {
+    if (*padrao == '\0') return *nome == '\0';
+    if (*padrao == '*') return casa_padrao(padrao + 1, nome) || (*nome != '\0' && casa_padrao(padrao, nome + 1));
+    if (*nome == '\0') return false;
+    return (*padrao == '?' || *padrao == *nome) && casa_padrao(padrao + 1, nome + 1);
+}
+
+//expande um padrao de arquivos (o curinga so é aceito no nome do arquivo, nao nos diretorios)
+//sem curinga, o caminho é devolvido como esta, para que a leitura reporte o erro se ele nao existir
+static vector<string> expandir_padrao(const string& padrao) {
+    if (padrao.find_first_of("*?") == string::npos) return {padrao};
+
+    std::filesystem::path caminho(padrao);
+    std::filesystem::path diretorio = caminho.parent_path().empty() ? "." : caminho.parent_path();
+    string padrao_nome = caminho.filename().string();
+
+    vector<string> arquivos;
+    std::error_code erro;
+    for (const auto& entrada : std::filesystem::directory_iterator(diretorio, erro)) {
+        if (entrada.is_regular_file() && casa_padrao(padrao_nome.c_str(), entrada.path().filename().string().c_str())) {
+            arquivos.push_back(entrada.path().string());
+        }
+    }
+    std::sort(arquivos.begin(), arquivos.end());
+    if (arquivos.empty()) cerr << "Nenhum arquivo corresponde a " << padrao << endl;
+    return arquivos;
+}
+
+static bool ler_alvos(const string& nome_arquivo, map<string, double>& alvos) {
+    std::ifstream arquivo(nome_arquivo);
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo de alvos: " << nome_arquivo << endl;
+        return false;
+    }
+    string nome;
+    double custo;
+    while (arquivo >> nome >> custo) alvos[nome] = custo;
+    return true;
+}
+
+//custo alvo de uma instancia: procurado pelo caminho, pelo nome do arquivo e pelo nome sem extensao
+static double alvo_da_instancia(const OpcoesExecucao& opcoes, const string& instancia) {
+    std::filesystem::path caminho(instancia);
+    for (const string& chave : {instancia, caminho.filename().string(), caminho.stem().string()}) {
+        auto it = opcoes.alvos.find(chave);
+        if (it != opcoes.alvos.end()) return it->second;
+    }
+    return opcoes.alvo_padrao;
+}
+
+//opcoes usadas que o motor assincrono nao implementa (ilhas, busca local na elite, reinicio e rastreamento),
+//para que elas nao sejam aceitas e ignoradas em silencio
+static vector<string> opcoes_incompativeis_assincrono(const OpcoesExecucao& opcoes) {
+    const ParametrosBRKGA padrao;
+    const ParametrosBRKGA& base = opcoes.base;
+    vector<string> incompativeis;
+    if (opcoes.ilhas.num_ilhas > 1) incompativeis.push_back("--ilhas");
+    if (opcoes.distribuido.papel != PAPEL_NENHUM) incompativeis.push_back("--distribuido");
+    if (base.busca_local_elite != padrao.busca_local_elite) incompativeis.push_back("--bl-elite");
+    if (base.intervalo_busca_local != padrao.intervalo_busca_local) incompativeis.push_back("--bl-intervalo");
+    if (base.tempo_busca_local_ms != padrao.tempo_busca_local_ms) incompativeis.push_back("--bl-tempo-ms");
+    if (base.movimentos_busca_local != padrao.movimentos_busca_local) incompativeis.push_back("--bl-movimentos");
+    if (base.recodificar_busca_local) incompativeis.push_back("--bl-recodificar");
+    if (base.diversidade_minima != padrao.diversidade_minima) incompativeis.push_back("--diversidade-min");
+    if (!opcoes.arquivo_rastro.empty()) incompativeis.push_back("--rastro");
+    return incompativeis;
+}
+
+//retorna false se a linha de comando for invalida (ou se a ajuda foi pedida)
+static bool ler_opcoes(int argc, char* argv[], OpcoesExecucao& opcoes) {
+    for (int i = 1; i < argc; ++i) {
+        string opcao = argv[i];
+        if (opcao == "-h" || opcao == "--ajuda") return false;
+        if (opcao == "--cache") {
+            opcoes.usar_cache_binario = true;
+            continue;
+        }
+        if (opcao == "--reducao") {
+            opcoes.reduzir = true;
+            continue;
+        }
+        if (opcao == "--assincrono") {
+            opcoes.assincrono = true;
+            continue;
+        }
+        if (opcao == "--bl-recodificar") {
+            opcoes.base.recodificar_busca_local = true;
+            continue;
+        }
+        if (opcao == "--parar-no-alvo") {
+            opcoes.base.parar_no_alvo = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Opcao sem valor: " << opcao << endl;
+            return false;
+        }
+        string valor = argv[++i];
+        try {
+            if (opcao == "-i" || opcao == "--instancias") {
+                for (const string& padrao : separar(valor, ',')) opcoes.padroes_instancias.push_back(padrao);
+            } else if (opcao == "-k" || opcao == "--k") {
+                opcoes.valores_k = ler_lista_inteiros<int>(valor);
+            } else if (opcao == "-s" || opcao == "--sementes") {
+                opcoes.sementes = ler_lista_inteiros<uint64_t>(valor);
+            } else if (opcao == "-r" || opcao == "--execucoes") {
+                opcoes.num_execucoes = std::stoi(valor);
+            } else if (opcao == "-p" || opcao == "--populacao") {
+                opcoes.populacoes = ler_lista_inteiros<int>(valor);
+            } else if (opcao == "-e" || opcao == "--elite") {
+                opcoes.elites = ler_lista_inteiros<int>(valor);
+            } else if (opcao == "-g" || opcao == "--geracoes") {
+                opcoes.geracoes = ler_lista_inteiros<int>(valor);
+            } else if (opcao == "-m" || opcao == "--mutantes") {
+                opcoes.mutantes = ler_lista_reais(valor);
+            } else if (opcao == "-t" || opcao == "--threads") {
+                opcoes.num_threads = std::stoi(valor);
+            } else if (opcao == "-d" || opcao == "--decodificador") {
+                if (valor == "varredura") opcoes.base.modo_decodificador = DECODIFICADOR_VARREDURA;
+                else if (valor == "fila") opcoes.base.modo_decodificador = DECODIFICADOR_FILA_PRIORIDADE;
+                else {
+                    cerr << "Decodificador desconhecido: " << valor << endl;
+                    return false;
+                }
+            } else if (opcao == "--tempo-limite") {
+                opcoes.base.tempo_limite_s = std::stod(valor);
+            } else if (opcao == "--estagnacao") {
+                opcoes.base.max_geracoes_sem_melhoria = std::stoi(valor);
+            } else if (opcao == "--diversidade-min") {
+                opcoes.base.diversidade_minima = std::stod(valor);
+            } else if (opcao == "--cache-fitness") {
+                opcoes.base.tamanho_cache_fitness = std::stoi(valor);
+            } else if (opcao == "--bl-elite") {
+                opcoes.base.busca_local_elite = std::stoi(valor);
+            } else if (opcao == "--bl-intervalo") {
+                opcoes.base.intervalo_busca_local = std::stoi(valor);
+            } else if (opcao == "--bl-tempo-ms") {
+                opcoes.base.tempo_busca_local_ms = std::stod(valor);
+            } else if (opcao == "--bl-movimentos") {
+                opcoes.base.movimentos_busca_local = std::stoll(valor);
+            } else if (opcao == "--alvo") {
+                opcoes.alvo_padrao = std::stod(valor);
+            } else if (opcao == "--alvos") {
+                if (!ler_alvos(valor, opcoes.alvos)) return false;
+            } else if (opcao == "--csv") {
+                opcoes.arquivo_csv = valor;
+            } else if (opcao == "--csv-execucoes") {
+                opcoes.arquivo_csv_execucoes = valor;
+            } else if (opcao == "--json") {
+                opcoes.arquivo_json = valor;
+            } else if (opcao == "--curvas") {
+                opcoes.arquivo_curvas = valor;
+            } else if (opcao == "--rastro") {
+                if (!RASTREAMENTO_ATIVO) cerr << "Aviso: --rastro sem efeito (compile com -DBRKGA_RASTREAMENTO)" << endl;
+                opcoes.arquivo_rastro = valor;
+            } else if (opcao == "--ilhas") {
+                opcoes.ilhas.num_ilhas = std::stoi(valor);
+            } else if (opcao == "--migracao") {
+                opcoes.ilhas.intervalo_migracao = std::stoi(valor);
+            } else if (opcao == "--migrantes") {
+                opcoes.ilhas.num_migrantes = std::stoi(valor);
+            } else if (opcao == "--topologia") {
+                if (valor == "anel") opcoes.ilhas.topologia = TOPOLOGIA_ANEL;
+                else if (valor == "todos") opcoes.ilhas.topologia = TOPOLOGIA_TODOS;
+                else {
+                    cerr << "Topologia desconhecida: " << valor << endl;
+                    return false;
+                }
+            } else if (opcao == "--distribuido") {
+                if (valor == "coordenador") opcoes.distribuido.papel = PAPEL_COORDENADOR;
+                else if (valor == "trabalhador") opcoes.distribuido.papel = PAPEL_TRABALHADOR;
+                else {
+                    cerr << "Papel desconhecido: " << valor << endl;
+                    return false;
+                }
+            } else if (opcao == "--endereco") {
+                opcoes.distribuido.endereco = valor;
+            } else if (opcao == "--processos") {
+                opcoes.distribuido.num_processos = std::stoi(valor);
+            } else if (opcao == "--espera-trabalhadores") {
+                opcoes.distribuido.espera_trabalhadores_s = std::stod(valor);
+            } else {
+                cerr << "Opcao desconhecida: " << opcao << endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            cerr << "Valor invalido para " << opcao << ": " << valor << endl;
+            return false;
+        }
+    }
+
+    //valores padrao das listas nao informadas
+    ParametrosBRKGA padrao;
+    if (opcoes.padroes_instancias.empty()) opcoes.padroes_instancias = {"instancias//scpclr10-3.txt"};
+    if (opcoes.valores_k.empty()) opcoes.valores_k = {1};
+    if (opcoes.populacoes.empty()) opcoes.populacoes = {padrao.tamanho_populacao};
+    if (opcoes.elites.empty()) opcoes.elites = {padrao.tamanho_elite};
+    if (opcoes.geracoes.empty()) opcoes.geracoes = {padrao.num_geracoes};
+    if (opcoes.mutantes.empty()) opcoes.mutantes = {padrao.percentual_mutantes};
+    if (opcoes.sementes.empty()) {
+        for (int i = 0; i < opcoes.num_execucoes; i++) opcoes.sementes.push_back(opcoes.semente_base + i);
+    }
+    opcoes.num_threads = std::max(1, opcoes.num_threads);
+    opcoes.distribuido.migracao = opcoes.ilhas;
+    return true;
+}
+
+//grade de parametros: todas as combinacoes validas (elite menor que a populacao)
+static vector<ParametrosBRKGA> montar_grade(const OpcoesExecucao& opcoes) {
+    vector<ParametrosBRKGA> grade;
+    for (int populacao : opcoes.populacoes)
+        for (int elite : opcoes.elites)
+            for (int geracoes : opcoes.geracoes)
+                for (float mutantes : opcoes.mutantes) {
+                    if (elite <= 0 || elite >= populacao) {
+                        cerr << "Configuracao ignorada: elite " << elite << " e populacao " << populacao << endl;
+                        continue;
+                    }
+                    ParametrosBRKGA parametros = opcoes.base;
+                    parametros.tamanho_populacao = populacao;
+                    parametros.tamanho_elite = elite;
+                    parametros.num_geracoes = geracoes;
+                    parametros.percentual_mutantes = mutantes;
+                    grade.push_back(parametros);
+                }
+    return grade;
+}
+
+//carrega a instancia para o valor k. Com o cache binario, cada k tem o seu arquivo; sem ele, o texto é lido
+//e as intersecoes entre os subconjuntos sao calculadas somente na primeira chamada (para k_minimo, o menor k da lista),
+//e nas seguintes os conflitos do novo k sao apenas derivados das intersecoes guardadas
+static bool carregar_instancia(const OpcoesExecucao& opcoes, const string& nome_arquivo, int k, int k_minimo,
+                               SCPCSInstance& inst, IntersecoesSubconjuntos& intersecoes, bool& lida) {
+    //tempo de pre-processamento: leitura do arquivo x construcao dos conflitos
+    auto inicio_leitura = std::chrono::steady_clock::now();
+    if (opcoes.usar_cache_binario) {
+        //leitura e conflitos vem juntos do arquivo binario (ou sao calculados e gravados nele)
+        inst = SCPCSInstance();
+        if (!ler_instancia_com_cache(nome_arquivo, inst, k)) return false;
+        cout << "Tempo de carregamento: "
+             << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio_leitura).count() << " ms" << endl;
+        return true;
+    }
+    if (!lida) {
+        if (!ler_instancia_scpcs(nome_arquivo, inst, k)) return false;
+        auto inicio_intersecoes = std::chrono::steady_clock::now();
+        calcular_intersecoes(inst, k_minimo, intersecoes);
+        lida = true;
+        cout << "Tempo de leitura: "
+             << std::chrono::duration<double, std::milli>(inicio_intersecoes - inicio_leitura).count() << " ms" << endl;
+        cout << "Tempo das intersecoes (k >= " << k_minimo << "): "
+             << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio_intersecoes).count()
+             << " ms, " << intersecoes.vizinhos.size() / 2 << " pares, " << intersecoes.memoria_bytes() / 1024.0 << " KB" << endl;
+    }
+    auto inicio_conflitos = std::chrono::steady_clock::now();
+    aplicar_conflitos_k(inst, intersecoes, k);
+    cout << "Tempo de construcao dos conflitos: "
+         << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio_conflitos).count() << " ms" << endl;
+    return true;
+}
+
+//reduz a instancia carregada (retorna false se nada foi removido, e entao a original é usada)
+static bool reduzir(const SCPCSInstance& inst, SCPCSInstance& reduzida, ReducaoInstancia& reducao) {
+    auto inicio = std::chrono::steady_clock::now();
+    bool reduziu = reduzir_instancia(inst, reduzida, reducao);
+    double tempo_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+    if (!reduziu && reducao.custo_excedido) {
+        cout << "Reducao: descartada, o custo ajustado de algum subconjunto passaria de INT_MAX (" << tempo_ms << " ms)" << endl;
+        return false;
+    }
+    if (!reduziu) {
+        cout << "Reducao: nenhum subconjunto removido (" << tempo_ms << " ms)" << endl;
+        return false;
+    }
+    cout << "Reducao: subconjuntos " << inst.num_subconjuntos << " -> " << reduzida.num_subconjuntos
+         << " (" << reducao.fixados.size() << " fixados, " << reducao.removidos_vazios << " sem elementos, "
+         << reducao.removidos_dominados << " dominados), elementos " << inst.num_elementos << " -> " << reduzida.num_elementos
+         << " (" << reducao.elementos_implicados << " implicados)"
+         << ", custo fixo " << reducao.custo_fixo << ", " << reducao.rodadas << " rodadas, " << tempo_ms << " ms" << endl;
+    cout << "Decodificador: " << descrever_variante(reduzida.variante) << " ("
+         << reduzida.especializada.memoria_bytes() / 1024.0 << " KB auxiliares)" << endl;
+    return true;
+}
+
+static const char* nome_motivo_parada(MotivoParada motivo) {
+    switch (motivo) {
+        case PARADA_TEMPO: return "tempo";
+        case PARADA_ALVO: return "alvo";
+        case PARADA_ESTAGNACAO: return "estagnacao";
+        case PARADA_EXTERNA: return "externa";
+        default: return "geracoes";
+    }
+}
+
+//executa em paralelo todas as execucoes de uma instancia ja carregada
+//com mais execucoes que threads, cada execucao usa 1 thread e as execucoes sao distribuidas entre os nucleos;
+//com menos, as threads que sobram sao divididas entre as execucoes para avaliar o fitness
+//no modelo de ilhas, as threads de cada execucao sao divididas entre as suas ilhas;
+//no motor assincrono, as threads de cada execucao evoluem a populacao sem barreira entre as geracoes;
+//no modo distribuido, o lote tem uma unica execucao, que usa todas as threads na ilha deste processo
+//com reducao, o BRKGA roda na instancia reduzida e o resultado é convertido e conferido na original
+static bool executar_lote(const SCPCSInstance& inst, const SCPCSInstance& original, const ReducaoInstancia* reducao,
+                          vector<Execucao>& execucoes, int num_threads, bool assincrono,
+                          const ParametrosIlhas& ilhas, const ParametrosDistribuido& distribuido, std::mutex& mutex_saida) {
+    bool usar_distribuido = distribuido.papel != PAPEL_NENHUM;
+    int total = (int)execucoes.size();
+    int threads_por_execucao = std::max(1, num_threads / std::max(1, total));
+    int num_trabalhadores = std::max(1, num_threads / threads_por_execucao);
+    bool usar_ilhas = ilhas.num_ilhas > 1;
+
+    //um pool de avaliacao por trabalhador, reaproveitado por todas as execucoes que ele pegar
+    //(as ilhas criam os seus proprios pools)
+    vector<unique_ptr<PoolThreads>> pools_avaliacao;
+    for (int t = 0; t < num_trabalhadores && !usar_ilhas; t++) {
+        pools_avaliacao.emplace_back(new PoolThreads(threads_por_execucao));
+    }
+
+    if (usar_distribuido) {
+        pools_avaliacao.clear();
+        pools_avaliacao.emplace_back(new PoolThreads(num_threads));
+    }
+
+    bool sucesso = true;
+    PoolThreads trabalhadores(num_trabalhadores);
+    trabalhadores.executar(total, [&](int i, int id_trabalhador) {
+        Execucao& execucao = execucoes[i];
+        //na reduzida, o alvo desconta o custo dos fixados (que toda solucao paga)
+        ParametrosBRKGA parametros = execucao.parametros;
+        if (reducao && parametros.custo_alvo >= 0) parametros.custo_alvo -= reducao->custo_fixo;
+        if (usar_distribuido) {
+            if (!brkga_distribuido(inst, parametros, distribuido, *pools_avaliacao[0], execucao.resultado)) {
+                sucesso = false;
+                return;
+            }
+        } else if (usar_ilhas) {
+            execucao.resultado = brkga_ilhas(inst, parametros, ilhas, threads_por_execucao);
+        } else if (assincrono) {
+            execucao.resultado = brkga_assincrono(inst, parametros, *pools_avaliacao[id_trabalhador]);
+        } else {
+            execucao.resultado = brkga(inst, parametros, *pools_avaliacao[id_trabalhador]);
+        }
+        if (reducao) {
+            restaurar_resultado(*reducao, execucao.resultado);
+            double conferido = calcular_custo_solucao(execucao.resultado.solucao, original);
+            if (std::abs(conferido - execucao.resultado.custo) > 1e-6) {
+                std::lock_guard<std::mutex> trava(mutex_saida);
+                cerr << "Erro: custo " << execucao.resultado.custo << " da solucao restaurada difere do custo na instancia original ("
+                     << conferido << ")" << endl;
+                sucesso = false;
+            }
+        }
+
+        std::lock_guard<std::mutex> trava(mutex_saida);
+        cout << execucao.instancia << " k=" << execucao.k
+             << " pop=" << execucao.parametros.tamanho_populacao << " elite=" << execucao.parametros.tamanho_elite
+             << " geracoes=" << execucao.parametros.num_geracoes << " mutantes=" << execucao.parametros.percentual_mutantes
+             << " semente=" << execucao.parametros.semente
+             << " | antes da busca local: " << execucao.resultado.custo_antes_busca_local
+             << " final: " << execucao.resultado.custo
+             << " tempo: " << execucao.resultado.tempo_s << " s"
+             << " melhor na geracao " << execucao.resultado.geracao_melhor << " (" << execucao.resultado.tempo_melhor_s << " s) de "
+             << execucao.resultado.geracoes << ", parada: " << nome_motivo_parada(execucao.resultado.motivo_parada)
+             << ", reinicios: " << execucao.resultado.reinicios
+             << " (reproducao " << execucao.resultado.tempo_reproducao_s << ", avaliacao " << execucao.resultado.tempo_avaliacao_s
+             << ", ordenacao " << execucao.resultado.tempo_ordenacao_s << ", busca local " << execucao.resultado.tempo_busca_local_s
+             << "; " << execucao.resultado.buscas_com_melhoria << "/" << execucao.resultado.buscas_locais << " refinamentos com melhoria)"
+             << " cache: " << execucao.resultado.acertos_cache << "/" << execucao.resultado.decodificacoes
+             << " acertos, ~" << execucao.resultado.tempo_economizado_cache_s << " s economizados"
+             << endl;
+    }, 1);
+    return sucesso;
+}
+
+// Resumo de uma configuracao (instancia, k e parametros) sobre todas as sementes
+struct Resumo {
+    const Execucao* exemplo = nullptr; //primeira execucao da configuracao (identifica instancia, k e parametros)
+    int execucoes = 0;
+    double melhor = 0.0, media = 0.0, desvio = 0.0;
+    double tempo_medio_s = 0.0;
+    int atingiram_alvo = 0;
+    double tempo_alvo_medio_s = -1.0; //media entre as execucoes que atingiram o alvo
+};
+
+static vector<Resumo> resumir(const vector<Execucao>& execucoes) {
+    //as execucoes de uma configuracao sao contiguas (as sementes variam por ultimo)
+    vector<Resumo> resumos;
+    for (size_t i = 0; i < execucoes.size();) {
+        size_t fim = i;
+        const ParametrosBRKGA& p = execucoes[i].parametros;
+        while (fim < execucoes.size() && execucoes[fim].instancia == execucoes[i].instancia && execucoes[fim].k == execucoes[i].k &&
+               execucoes[fim].parametros.tamanho_populacao == p.tamanho_populacao &&
+               execucoes[fim].parametros.tamanho_elite == p.tamanho_elite &&
+               execucoes[fim].parametros.num_geracoes == p.num_geracoes &&
+               execucoes[fim].parametros.percentual_mutantes == p.percentual_mutantes) {
+            fim++;
+        }
+        Resumo resumo;
+        resumo.exemplo = &execucoes[i];
+        resumo.execucoes = (int)(fim - i);
+        resumo.melhor = execucoes[i].resultado.custo;
+        double soma_tempo_alvo = 0.0;
+        for (size_t j = i; j < fim; j++) {
+            const ResultadoBRKGA& r = execucoes[j].resultado;
+            resumo.melhor = std::min(resumo.melhor, r.custo);
+            resumo.media += r.custo;
+            resumo.tempo_medio_s += r.tempo_s;
+            if (r.tempo_alvo_s >= 0) {
+                resumo.atingiram_alvo++;
+                soma_tempo_alvo += r.tempo_alvo_s;
+            }
+        }
+        resumo.media /= resumo.execucoes;
+        resumo.tempo_medio_s /= resumo.execucoes;
+        for (size_t j = i; j < fim; j++) {
+            double d = execucoes[j].resultado.custo - resumo.media;
+            resumo.desvio += d * d;
+        }
+        resumo.desvio = std::sqrt(resumo.desvio / resumo.execucoes);
+        if (resumo.atingiram_alvo > 0) resumo.tempo_alvo_medio_s = soma_tempo_alvo / resumo.atingiram_alvo;
+        resumos.push_back(resumo);
+        i = fim;
+    }
+    return resumos;
+}
+
+static void escrever_configuracao_csv(std::ostream& saida, const Execucao& e) {
+    saida << e.instancia << ";" << e.k << ";" << e.parametros.tamanho_populacao << ";" << e.parametros.tamanho_elite << ";"
+          << e.parametros.num_geracoes << ";" << e.parametros.percentual_mutantes;
+}
+
+static const char* CABECALHO_CONFIGURACAO = "instancia;k;populacao;elite;geracoes;mutantes";
+
+static void escrever_resumo_csv(std::ostream& saida, const vector<Resumo>& resumos) {
+    saida << CABECALHO_CONFIGURACAO << ";execucoes;melhor;media;desvio;tempo_medio_s;atingiram_alvo;tempo_alvo_medio_s\n";
+    for (const Resumo& r : resumos) {
+        escrever_configuracao_csv(saida, *r.exemplo);
+        saida << ";" << r.execucoes << ";" << r.melhor << ";" << r.media << ";" << r.desvio << ";" << r.tempo_medio_s << ";"
+              << r.atingiram_alvo << ";";
+        if (r.tempo_alvo_medio_s >= 0) saida << r.tempo_alvo_medio_s;
+        saida << "\n";
+    }
+}
+
+static void escrever_execucoes_csv(std::ostream& saida, const vector<Execucao>& execucoes) {
+    saida << CABECALHO_CONFIGURACAO
+          << ";semente;custo_antes_busca_local;custo;tempo_s;tempo_melhor_s;geracao_melhor;tempo_alvo_s;geracoes;motivo_parada;reinicios"
+          << ";tempo_reproducao_s;tempo_avaliacao_s;tempo_ordenacao_s;tempo_busca_local_s;buscas_locais;buscas_com_melhoria"
+          << ";decodificacoes;acertos_cache;tempo_economizado_cache_s\n";
+    for (const Execucao& e : execucoes) {
+        const ResultadoBRKGA& r = e.resultado;
+        escrever_configuracao_csv(saida, e);
+        saida << ";" << e.parametros.semente << ";" << r.custo_antes_busca_local << ";" << r.custo << ";" << r.tempo_s << ";"
+              << r.tempo_melhor_s << ";" << r.geracao_melhor << ";";
+        if (r.tempo_alvo_s >= 0) saida << r.tempo_alvo_s;
+        saida << ";" << r.geracoes << ";" << nome_motivo_parada(r.motivo_parada) << ";" << r.reinicios;
+        saida << ";" << r.tempo_reproducao_s << ";" << r.tempo_avaliacao_s << ";" << r.tempo_ordenacao_s << ";"
+              << r.tempo_busca_local_s << ";" << r.buscas_locais << ";" << r.buscas_com_melhoria << ";"
+              << r.decodificacoes << ";" << r.acertos_cache << ";" << r.tempo_economizado_cache_s;
+        saida << "\n";
+    }
+}
+
+static void escrever_curvas_csv(std::ostream& saida, const vector<Execucao>& execucoes) {
+    saida << CABECALHO_CONFIGURACAO << ";semente;ilha;geracao;tempo_s;melhor\n";
+    for (const Execucao& e : execucoes) {
+        for (const PontoConvergencia& ponto : e.resultado.convergencia) {
+            escrever_configuracao_csv(saida, e);
+            saida << ";" << e.parametros.semente << ";" << ponto.ilha << ";" << ponto.geracao << ";" << ponto.tempo_s << ";"
+                  << ponto.melhor << "\n";
+        }
+    }
+}
+
+//texto entre aspas para o JSON (os nomes de arquivo sao os unicos textos gravados)
+static string texto_json(const string& texto) {
+    string saida = "\"";
+    for (char c : texto) {
+        if (c == '"' || c == '\\') saida += '\\';
+        saida += c;
+    }
+    return saida + "\"";
+}
+
+static void escrever_configuracao_json(std::ostream& saida, const Execucao& e) {
+    saida << "\"instancia\": " << texto_json(e.instancia) << ", \"k\": " << e.k
+          << ", \"populacao\": " << e.parametros.tamanho_populacao << ", \"elite\": " << e.parametros.tamanho_elite
+          << ", \"geracoes\": " << e.parametros.num_geracoes << ", \"mutantes\": " << e.parametros.percentual_mutantes;
+}
+
+static void escrever_json(std::ostream& saida, const vector<Execucao>& execucoes, const vector<Resumo>& resumos,
+                          double tempo_total_s) {
+    saida << "{\n  \"tempo_total_s\": " << tempo_total_s << ",\n  \"execucoes\": [\n";
+    for (size_t i = 0; i < execucoes.size(); i++) {
+        const Execucao& e = execucoes[i];
+        const ResultadoBRKGA& r = e.resultado;
+        saida << "    {";
+        escrever_configuracao_json(saida, e);
+        saida << ", \"semente\": " << e.parametros.semente << ", \"custo_antes_busca_local\": " << r.custo_antes_busca_local
+              << ", \"custo\": " << r.custo << ", \"tempo_s\": " << r.tempo_s << ", \"tempo_melhor_s\": " << r.tempo_melhor_s
+              << ", \"geracao_melhor\": " << r.geracao_melhor << ", \"tempo_alvo_s\": ";
+        if (r.tempo_alvo_s >= 0) saida << r.tempo_alvo_s;
+        else saida << "null";
+        saida << ", \"geracoes\": " << r.geracoes << ", \"motivo_parada\": \"" << nome_motivo_parada(r.motivo_parada) << "\""
+              << ", \"reinicios\": " << r.reinicios;
+        saida << ", \"tempo_reproducao_s\": " << r.tempo_reproducao_s << ", \"tempo_avaliacao_s\": " << r.tempo_avaliacao_s
+              << ", \"tempo_ordenacao_s\": " << r.tempo_ordenacao_s << ", \"tempo_busca_local_s\": " << r.tempo_busca_local_s
+              << ", \"buscas_locais\": " << r.buscas_locais << ", \"buscas_com_melhoria\": " << r.buscas_com_melhoria;
+        saida << ", \"decodificacoes\": " << r.decodificacoes << ", \"acertos_cache\": " << r.acertos_cache
+              << ", \"tempo_economizado_cache_s\": " << r.tempo_economizado_cache_s;
+        saida << ", \"solucao\": [";
+        bool primeiro = true;
+        for (int j : r.solucao) {
+            saida << (primeiro ? "" : ", ") << j + 1;
+            primeiro = false;
+        }
+        saida << "]}" << (i + 1 < execucoes.size() ? "," : "") << "\n";
+    }
+    saida << "  ],\n  \"resumo\": [\n";
+    for (size_t i = 0; i < resumos.size(); i++) {
+        const Resumo& r = resumos[i];
+        saida << "    {";
+        escrever_configuracao_json(saida, *r.exemplo);
+        saida << ", \"execucoes\": " << r.execucoes << ", \"melhor\": " << r.melhor << ", \"media\": " << r.media
+              << ", \"desvio\": " << r.desvio << ", \"tempo_medio_s\": " << r.tempo_medio_s
+              << ", \"atingiram_alvo\": " << r.atingiram_alvo << ", \"tempo_alvo_medio_s\": ";
+        if (r.tempo_alvo_medio_s >= 0) saida << r.tempo_alvo_medio_s;
+        else saida << "null";
+        saida << "}" << (i + 1 < resumos.size() ? "," : "") << "\n";
+    }
+    saida << "  ]\n}\n";
+}
+
+//rastreamento em JSON lines: uma linha por geracao de cada execucao e ilha, com a configuracao repetida em cada
+//linha para que o arquivo possa ser filtrado linha a linha; iteracoes e saidas da LCR sao por decodificacao feitas
+//(sem os acertos do cache) e a ociosidade de cada thread na avaliacao é o tempo da etapa menos o tempo ocupado
+static void escrever_rastro_jsonl(std::ostream& saida, const vector<Execucao>& execucoes) {
+    for (const Execucao& e : execucoes) {
+        for (const RegistroGeracao& r : e.resultado.rastro) {
+            long long feitas = r.decodificacoes - r.acertos_cache;
+            saida << "{";
+            escrever_configuracao_json(saida, e);
+            saida << ", \"semente\": " << e.parametros.semente << ", \"ilha\": " << r.ilha << ", \"geracao\": " << r.geracao
+                  << ", \"tempo_s\": " << r.tempo_s << ", \"melhor\": " << r.melhor
+                  << ", \"tempo_reproducao_s\": " << r.tempo_reproducao_s << ", \"tempo_mutantes_s\": " << r.tempo_mutantes_s
+                  << ", \"tempo_crossover_s\": " << r.tempo_crossover_s << ", \"tempo_avaliacao_s\": " << r.tempo_avaliacao_s;
+            saida << ", \"avaliacao_ocupado_s\": [";
+            for (size_t t = 0; t < r.avaliacao_ocupado_s.size(); t++) {
+                saida << (t ? ", " : "") << r.avaliacao_ocupado_s[t];
+            }
+            saida << "], \"avaliacao_ociosa_s\": [";
+            for (size_t t = 0; t < r.avaliacao_ocupado_s.size(); t++) {
+                saida << (t ? ", " : "") << std::max(0.0, r.tempo_avaliacao_s - r.avaliacao_ocupado_s[t]);
+            }
+            saida << "], \"tempo_ordenacao_s\": " << r.tempo_ordenacao_s << ", \"tempo_busca_local_s\": " << r.tempo_busca_local_s
+                  << ", \"decodificacoes\": " << r.decodificacoes << ", \"acertos_cache\": " << r.acertos_cache
+                  << ", \"tempo_economizado_cache_s\": " << r.tempo_economizado_cache_s
+                  << ", \"iteracoes_medias\": " << (feitas > 0 ? (double)r.iteracoes_gulosas / feitas : 0.0)
+                  << ", \"taxa_fora_lcr\": " << (feitas > 0 ? (double)r.usos_fora_lcr / feitas : 0.0)
+                  << ", \"reinicios\": " << r.reinicios << "}\n";
+        }
+    }
+}
+
+//grava um arquivo de resultados (nome vazio = opcao nao usada)
+template <typename Escrita>
+static void gravar_arquivo(const string& nome_arquivo, Escrita escrita) {
+    if (nome_arquivo.empty()) return;
+    std::ofstream arquivo(nome_arquivo);
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao gravar o arquivo: " << nome_arquivo << endl;
+        return;
+    }
+    escrita(arquivo);
+}
+
+int main(int argc, char* argv[]){
+    OpcoesExecucao opcoes;
+    if (!ler_opcoes(argc, argv, opcoes)) {
+        exibir_uso();
+        return 1;
+    }
+
+    vector<string> instancias;
+    for (const string& padrao : opcoes.padroes_instancias) {
+        for (const string& arquivo : expandir_padrao(padrao)) instancias.push_back(arquivo);
+    }
+    vector<ParametrosBRKGA> grade = montar_grade(opcoes);
+    if (instancias.empty() || grade.empty() || opcoes.sementes.empty()) {
+        cerr << "Nenhuma execucao a fazer" << endl;
+        return 1;
+    }
+    bool distribuido = opcoes.distribuido.papel != PAPEL_NENHUM;
+    if (opcoes.assincrono) {
+        vector<string> incompativeis = opcoes_incompativeis_assincrono(opcoes);
+        if (!incompativeis.empty()) {
+            cerr << "--assincrono nao pode ser combinado com";
+            for (const string& opcao : incompativeis) cerr << " " << opcao;
+            cerr << endl;
+            return 1;
+        }
+    }
+    if (distribuido) {
+        //o modo distribuido faz uma unica execucao (a semente usada é a do coordenador)
+        instancias.resize(1);
+        opcoes.valores_k.resize(1);
+        grade.resize(1);
+        opcoes.sementes.resize(1);
+    }
+
+    cout << "instancias: " << instancias.size() << endl;
+    cout << "configuracoes: " << grade.size() << endl;
+    cout << "sementes: " << opcoes.sementes.size() << endl;
+    cout << "threads: " << opcoes.num_threads << endl;
+    if (opcoes.assincrono) cout << "motor: assincrono (estado estacionario)" << endl;
+    if (opcoes.ilhas.num_ilhas > 1) {
+        cout << "ilhas: " << opcoes.ilhas.num_ilhas << " (migracao a cada " << opcoes.ilhas.intervalo_migracao << " geracoes, "
+             << opcoes.ilhas.num_migrantes << " migrantes, topologia "
+             << (opcoes.ilhas.topologia == TOPOLOGIA_ANEL ? "anel" : "todos") << ")" << endl;
+    }
+    if (distribuido) {
+        cout << "distribuido: " << (opcoes.distribuido.papel == PAPEL_COORDENADOR ? "coordenador" : "trabalhador")
+             << " em " << opcoes.distribuido.endereco << " (" << opcoes.distribuido.num_processos << " processos, migracao a cada "
+             << opcoes.distribuido.migracao.intervalo_migracao << " geracoes)" << endl;
+    }
+
+    std::mutex mutex_saida;
+    vector<Execucao> todas_execucoes;
+    auto inicio_total = std::chrono::steady_clock::now();
+
+    //as instancias sao carregadas uma de cada vez (os grafos de conflitos das maiores ocupam centenas de MB)
+    //e todas as execucoes da instancia rodam em paralelo antes que a proxima seja carregada
+    //a instancia é lida uma unica vez para todos os valores de k (varredura de k): somente os conflitos sao refeitos
+    int k_minimo = *std::min_element(opcoes.valores_k.begin(), opcoes.valores_k.end());
+    for (const string& nome_arquivo : instancias) {
+        SCPCSInstance inst;
+        IntersecoesSubconjuntos intersecoes;
+        bool lida = false;
+        for (int k : opcoes.valores_k) {
+            cout << "instancia: " << nome_arquivo << "  k: " << k << endl;
+            if (!carregar_instancia(opcoes, nome_arquivo, k, k_minimo, inst, intersecoes, lida)) {
+                if (!opcoes.usar_cache_binario) break; //sem o arquivo texto nao ha o que derivar para os outros k
+                continue;
+            }
+
+            SCPCSInstance reduzida;
+            ReducaoInstancia reducao;
+            bool reduziu = opcoes.reduzir && reduzir(inst, reduzida, reducao);
+
+            vector<Execucao> execucoes;
+            for (const ParametrosBRKGA& configuracao : grade) {
+                for (uint64_t semente : opcoes.sementes) {
+                    Execucao execucao;
+                    execucao.instancia = nome_arquivo;
+                    execucao.k = k;
+                    execucao.parametros = configuracao;
+                    execucao.parametros.semente = semente;
+                    execucao.parametros.custo_alvo = alvo_da_instancia(opcoes, nome_arquivo);
+                    execucoes.push_back(execucao);
+                }
+            }
+            if (!executar_lote(reduziu ? reduzida : inst, inst, reduziu ? &reducao : nullptr, execucoes, opcoes.num_threads,
+                               opcoes.assincrono, opcoes.ilhas, opcoes.distribuido, mutex_saida)) return 1;
+            todas_execucoes.insert(todas_execucoes.end(), std::make_move_iterator(execucoes.begin()),
+                                   std::make_move_iterator(execucoes.end()));
+        }
+    }
+    double tempo_total_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio_total).count();
+    if (todas_execucoes.empty()) return 1;
+
+    vector<Resumo> resumos = resumir(todas_execucoes);
+    cout << endl;
+    escrever_resumo_csv(cout, resumos);
+    cout << "Execucoes: " << todas_execucoes.size() << "  tempo total: " << tempo_total_s << " s"
+         << "  execucoes/hora: " << todas_execucoes.size() * 3600.0 / tempo_total_s << endl;
+
+    if (opcoes.distribuido.papel == PAPEL_TRABALHADOR) return 0; //os arquivos de resultados sao gravados pelo coordenador
+    gravar_arquivo(opcoes.arquivo_csv, [&](std::ostream& saida) { escrever_resumo_csv(saida, resumos); });
+    gravar_arquivo(opcoes.arquivo_csv_execucoes, [&](std::ostream& saida) { escrever_execucoes_csv(saida, todas_execucoes); });
+    gravar_arquivo(opcoes.arquivo_curvas, [&](std::ostream& saida) { escrever_curvas_csv(saida, todas_execucoes); });
+    gravar_arquivo(opcoes.arquivo_rastro, [&](std::ostream& saida) { escrever_rastro_jsonl(saida, todas_execucoes); });
+    gravar_arquivo(opcoes.arquivo_json, [&](std::ostream& saida) { escrever_json(saida, todas_execucoes, resumos, tempo_total_s); });
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "pool_threads.hpp"
+#include <algorithm>
+
+using namespace std;
+
+PoolThreads::PoolThreads(int num_threads)
+    : total_threads(std::max(1, num_threads)),
+      particoes(new Particao[std::max(1, num_threads)]) {
+    //a thread 0 é a que chama executar(), por isso so sao criadas total_threads - 1 threads
+    for (int id = 1; id < total_threads; ++id) {
+        trabalhadores.emplace_back(&PoolThreads::laco_trabalhador, this, id);
+    }
+}
+
+PoolThreads::~PoolThreads() {
+    {
+        std::lock_guard<std::mutex> trava(mutex_pool);
+        parar = true;
+    }
+    cv_inicio.notify_all();
+    for (auto& trabalhador : trabalhadores) {
+        trabalhador.join();
+    }
+}
+
+void PoolThreads::executar(int total, const Tarefa& tarefa, int tamanho_bloco) {
+    if (total <= 0) return;
+
+    //bloco automatico: cerca de 4 blocos por thread, para que o roubo de trabalho compense
+    //decodificacoes com duracoes muito diferentes sem disputar o contador a cada indice
+    if (tamanho_bloco <= 0) {
+        tamanho_bloco = std::max(1, total / (4 * total_threads));
+    }
+
+    //divide [0, total) em particoes contiguas, uma por thread
+    for (int t = 0; t < total_threads; ++t) {
+        long long inicio = (long long)total * t / total_threads;
+        long long fim = (long long)total * (t + 1) / total_threads;
+        particoes[t].proximo.store((int)inicio, std::memory_order_relaxed);
+        particoes[t].fim = (int)fim;
+    }
+    tarefa_atual = &tarefa;
+    bloco_atual = tamanho_bloco;
+
+    {
+        std::lock_guard<std::mutex> trava(mutex_pool);
+        pendentes = total_threads - 1;
+        rodada++;
+    }
+    cv_inicio.notify_all();
+
+    trabalhar(0);
+
+    //espera os demais trabalhadores terminarem a rodada
+    std::unique_lock<std::mutex> trava(mutex_pool);
+    cv_fim.wait(trava, [this] { return pendentes == 0; });
+    tarefa_atual = nullptr;
+}
+
+void PoolThreads::laco_trabalhador(int id_thread) {
+    long long ultima_rodada = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> trava(mutex_pool);
+            cv_inicio.wait(trava, [&] { return parar || rodada != ultima_rodada; });
+            if (parar) return;
+            ultima_rodada = rodada;
+        }
+
+        trabalhar(id_thread);
+
+        bool ultimo;
+        {
+            std::lock_guard<std::mutex> trava(mutex_pool);
+            ultimo = (--pendentes == 0);
+        }
+        if (ultimo) cv_fim.notify_one();
+    }
+}
+
+void PoolThreads::trabalhar(int id_thread) {
+    const Tarefa& tarefa = *tarefa_atual;
+
+    //comeca pela propria particao e depois percorre as das outras threads (roubo de trabalho)
+    for (int deslocamento = 0; deslocamento < total_threads; ++deslocamento) {
+        Particao& particao = particoes[(id_thread + deslocamento) % total_threads];
+        while (true) {
+            int inicio = particao.proximo.fetch_add(bloco_atual, std::memory_order_relaxed);
+            if (inicio >= particao.fim) break;
+            int fim = std::min(particao.fim, inicio + bloco_atual);
+            for (int i = inicio; i < fim; ++i) {
+                tarefa(i, id_thread);
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef POOL_THREADS_HPP
+#define POOL_THREADS_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de threads persistente (criado uma vez e reutilizado em todas as geracoes)
+// executar() divide o intervalo [0, total) em uma particao por thread; cada thread consome blocos
+// da sua particao e, quando ela acaba, rouba blocos das particoes das outras threads
+// a thread que chama executar() tambem trabalha (como thread 0), entao o pool cria num_threads - 1 threads
+class PoolThreads {
+public:
+    //tarefa(indice, id_thread): id_thread está em [0, num_threads) e identifica a thread que executa o indice
+    using Tarefa = std::function<void(int indice, int id_thread)>;
+
+    explicit PoolThreads(int num_threads);
+    ~PoolThreads();
+
+    PoolThreads(const PoolThreads&) = delete;
+    PoolThreads& operator=(const PoolThreads&) = delete;
+
+    int num_threads() const { return total_threads; }
+
+    //executa tarefa(i, id_thread) para todo i em [0, total) e retorna quando todos terminarem
+    //tamanho_bloco <= 0 escolhe automaticamente um bloco pequeno o bastante para balancear a carga
+    void executar(int total, const Tarefa& tarefa, int tamanho_bloco = 0);
+
+private:
+    //particao de indices de uma thread; proximo é disputado pela dona e pelas ladras
+    struct alignas(64) Particao {
+        std::atomic<int> proximo{0};
+        int fim = 0;
+    };
+
+    void laco_trabalhador(int id_thread);
+    void trabalhar(int id_thread);
+
+    int total_threads;
+    std::vector<std::thread> trabalhadores;
+    std::unique_ptr<Particao[]> particoes;
+
+    //estado da rodada atual (escrito por executar() antes de liberar os trabalhadores)
+    const Tarefa* tarefa_atual = nullptr;
+    int bloco_atual = 1;
+
+    std::mutex mutex_pool;
+    std::condition_variable cv_inicio;
+    std::condition_variable cv_fim;
+    long long rodada = 0;  //incrementado a cada chamada de executar()
+    int pendentes = 0;     //trabalhadores que ainda nao terminaram a rodada atual
+    bool parar = false;
+};
+
+#endif // POOL_THREADS_HPP
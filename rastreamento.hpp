@@ -0,0 +1,46 @@
+#ifndef RASTREAMENTO_HPP
+#define RASTREAMENTO_HPP
+
+#include <vector>
+
+// Rastreamento por geracao do BRKGA, ligado na compilacao com -DBRKGA_RASTREAMENTO.
+// Desligado, as medicoes ficam em blocos "if constexpr (RASTREAMENTO_ATIVO)" e sao descartadas pelo compilador,
+// entao o laco das geracoes nao paga nenhuma leitura de relogio ou contador a mais.
+#ifdef BRKGA_RASTREAMENTO
+constexpr bool RASTREAMENTO_ATIVO = true;
+#else
+constexpr bool RASTREAMENTO_ATIVO = false;
+#endif
+
+// Medicoes acumuladas por uma thread do pool durante uma geracao (zeradas a cada geracao)
+struct MedicoesThread {
+    double tempo_mutantes_s = 0.0;
+    double tempo_crossover_s = 0.0;
+    double tempo_avaliacao_s = 0.0; //tempo ocupado decodificando
+    long long iteracoes_gulosas = 0; //subconjuntos escolhidos nas decodificacoes feitas (sem os acertos do cache)
+    int usos_fora_lcr = 0; //decodificacoes em que a LCR se esgotou e a busca continuou no restante da lista
+};
+
+// Registro de uma geracao (geracao 0 = populacao inicial)
+// os tempos de etapa sao de relogio; os de mutantes e crossover sao somados entre as threads
+struct RegistroGeracao {
+    int ilha = 0;
+    int geracao = 0;
+    double tempo_s = 0.0; //instante do fim da geracao
+    double melhor = 0.0;
+    double tempo_reproducao_s = 0.0;
+    double tempo_mutantes_s = 0.0;
+    double tempo_crossover_s = 0.0;
+    double tempo_avaliacao_s = 0.0;
+    std::vector<double> avaliacao_ocupado_s; //por thread do pool (ociosa = tempo_avaliacao_s - ocupado)
+    double tempo_ordenacao_s = 0.0;
+    double tempo_busca_local_s = 0.0;
+    long long decodificacoes = 0;
+    long long acertos_cache = 0;
+    double tempo_economizado_cache_s = 0.0; //estimativa: acertos x tempo medio das decodificacoes feitas na geracao
+    long long iteracoes_gulosas = 0;
+    int usos_fora_lcr = 0;
+    int reinicios = 0; //reinicios da populacao nesta geracao
+};
+
+#endif // RASTREAMENTO_HPP
@@ -0,0 +1,228 @@
+#include "reducao.hpp"
+#include <climits>
+
+using namespace std;
+
+//os subconjuntos ativos que cobrem e estao entre os que cobrem f (as duas linhas estao ordenadas)
+static bool implica(const SCPCSInstance& inst, int e, int f, const vector<char>& ativo) {
+    Intervalo<int> cobertores_f = inst.lista_incidencia[f];
+    const int* pf = cobertores_f.begin();
+    for (int j : inst.lista_incidencia[e]) {
+        if (!ativo[j]) continue;
+        while (pf != cobertores_f.end() && *pf < j) ++pf;
+        if (pf == cobertores_f.end() || *pf != j) return false;
+    }
+    return true;
+}
+
+//b domina a: cobre os elementos ainda a cobrir de a e, com cada subconjunto restante s (s != a, b),
+//tem penalidade no maximo igual a de a (custo e cardinalidade ja foram comparados por quem chama)
+static bool domina(const SCPCSInstance& inst, int b, int a, const vector<char>& ativo, const vector<char>& resolvido) {
+    //inclusao dos elementos: as duas linhas estao ordenadas
+    Intervalo<int> elementos_b = inst.matriz_incidencia[b];
+    const int* pb = elementos_b.begin();
+    for (int e : inst.matriz_incidencia[a]) {
+        if (resolvido[e]) continue;
+        while (pb != elementos_b.end() && *pb < e) ++pb;
+        if (pb == elementos_b.end() || *pb != e) return false;
+    }
+
+    //penalidades: para cada vizinho s de b, a precisa ter com s uma penalidade no minimo igual
+    const GrafoConflitos& grafo = inst.conflitos;
+    int pa = grafo.inicio[a];
+    for (int p = grafo.inicio[b]; p < grafo.inicio[b + 1]; ++p) {
+        int s = grafo.vizinhos[p];
+        if (s == a || !ativo[s]) continue;
+        while (pa < grafo.inicio[a + 1] && grafo.vizinhos[pa] < s) ++pa;
+        double penalidade_a = (pa < grafo.inicio[a + 1] && grafo.vizinhos[pa] == s) ? grafo.penalidades[pa] : 0.0;
+        if (grafo.penalidades[p] > penalidade_a) return false;
+    }
+    return true;
+}
+
+bool reduzir_instancia(const SCPCSInstance& original, SCPCSInstance& reduzida, ReducaoInstancia& reducao) {
+    int n = original.num_subconjuntos;
+    int m = original.num_elementos;
+    const GrafoConflitos& grafo = original.conflitos;
+    reducao = ReducaoInstancia();
+    reducao.subconjuntos_originais = n;
+    reducao.elementos_originais = m;
+
+    //estado da reducao sobre os indices originais
+    vector<char> ativo(n, 1);       //subconjunto ainda na instancia (nem fixado nem removido)
+    vector<char> resolvido(m, 0);   //elemento coberto por um fixado ou implicado por outro
+    vector<int> cobertores(m);      //subconjuntos ativos que cobrem o elemento
+    vector<int> tamanho(n);         //elementos ainda a cobrir do subconjunto
+    vector<long long> custo(original.custos.begin(), original.custos.end()); //custo somado as penalidades com os fixados
+    for (int e = 0; e < m; ++e) cobertores[e] = (int)original.lista_incidencia[e].size();
+    for (int j = 0; j < n; ++j) tamanho[j] = (int)original.matriz_incidencia[j].size();
+
+    auto fixar = [&](int j) {
+        ativo[j] = 0;
+        reducao.fixados.push_back(j);
+        reducao.custo_fixo += custo[j];
+        for (int p = grafo.inicio[j]; p < grafo.inicio[j + 1]; ++p) {
+            if (ativo[grafo.vizinhos[p]]) custo[grafo.vizinhos[p]] += (long long)grafo.penalidades[p];
+        }
+        for (int e : original.matriz_incidencia[j]) {
+            if (resolvido[e]) continue;
+            resolvido[e] = 1;
+            for (int s : original.lista_incidencia[e]) {
+                if (ativo[s]) tamanho[s]--;
+            }
+        }
+    };
+    auto descartar_elemento = [&](int f) {
+        resolvido[f] = 1;
+        for (int s : original.lista_incidencia[f]) {
+            if (ativo[s]) tamanho[s]--;
+        }
+    };
+    auto remover = [&](int j) {
+        ativo[j] = 0;
+        for (int e : original.matriz_incidencia[j]) {
+            if (!resolvido[e]) cobertores[e]--;
+        }
+    };
+
+    bool mudou = true;
+    while (mudou) {
+        mudou = false;
+        reducao.rodadas++;
+
+        //elementos com uma unica cobertura (os sem nenhuma ficam na reduzida, como na original)
+        for (int e = 0; e < m; ++e) {
+            if (resolvido[e] || cobertores[e] != 1) continue;
+            for (int j : original.lista_incidencia[e]) {
+                if (!ativo[j]) continue;
+                fixar(j);
+                mudou = true;
+                break;
+            }
+        }
+
+        //elemento implicado: toda cobertura de e cobre f, entao f sai da instancia (cobrir e ja cobre f).
+        //os candidatos a f estao no primeiro subconjunto ativo que cobre e
+        for (int e = 0; e < m; ++e) {
+            if (resolvido[e] || cobertores[e] == 0) continue;
+            int primeiro = -1;
+            for (int j : original.lista_incidencia[e]) {
+                if (ativo[j]) {
+                    primeiro = j;
+                    break;
+                }
+            }
+            for (int f : original.matriz_incidencia[primeiro]) {
+                if (f == e || resolvido[f] || cobertores[f] < cobertores[e]) continue;
+                if (implica(original, e, f, ativo)) {
+                    descartar_elemento(f);
+                    reducao.elementos_implicados++;
+                    mudou = true;
+                }
+            }
+        }
+
+        for (int j = 0; j < n; ++j) {
+            if (ativo[j] && tamanho[j] == 0) {
+                remover(j);
+                reducao.removidos_vazios++;
+                mudou = true;
+            }
+        }
+
+        //dominancia: os candidatos a dominar a sao os que cobrem o seu elemento com menos coberturas
+        for (int a = 0; a < n; ++a) {
+            if (!ativo[a]) continue;
+            int raro = -1;
+            for (int e : original.matriz_incidencia[a]) {
+                if (!resolvido[e] && (raro < 0 || cobertores[e] < cobertores[raro])) raro = e;
+            }
+            for (int b : original.lista_incidencia[raro]) {
+                if (b == a || !ativo[b] || tamanho[b] < tamanho[a] || custo[b] > custo[a]) continue;
+                if (domina(original, b, a, ativo, resolvido)) {
+                    remover(a);
+                    reducao.removidos_dominados++;
+                    mudou = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (reducao.fixados.empty() && reducao.elementos_implicados == 0 && reducao.removidos_vazios == 0 &&
+        reducao.removidos_dominados == 0) {
+        return false;
+    }
+    for (int j = 0; j < n; ++j) {
+        if (ativo[j] && custo[j] > INT_MAX) {
+            reducao.custo_excedido = true;
+            return false;
+        }
+    }
+
+    //reindexacao crescente: as linhas mapeadas continuam ordenadas
+    vector<int> novo_elemento(m, -1);
+    int m_reduzido = 0;
+    for (int e = 0; e < m; ++e) {
+        if (!resolvido[e]) novo_elemento[e] = m_reduzido++;
+    }
+    vector<int> novo_subconjunto(n, -1);
+    for (int j = 0; j < n; ++j) {
+        if (!ativo[j]) continue;
+        novo_subconjunto[j] = (int)reducao.originais.size();
+        reducao.originais.push_back(j);
+    }
+    int n_reduzido = (int)reducao.originais.size();
+
+    reduzida = SCPCSInstance();
+    reduzida.num_elementos = m_reduzido;
+    reduzida.num_subconjuntos = n_reduzido;
+    reduzida.conflict_threshold = original.conflict_threshold;
+    reduzida.custos.resize(n_reduzido);
+
+    MatrizCSR<int>& matriz = reduzida.matriz_incidencia;
+    GrafoConflitos& conflitos = reduzida.conflitos;
+    matriz.inicio.assign(1, 0);
+    conflitos.inicio.assign(1, 0);
+    for (int j : reducao.originais) {
+        reduzida.custos[novo_subconjunto[j]] = (int)custo[j];
+        for (int e : original.matriz_incidencia[j]) {
+            if (!resolvido[e]) matriz.indices.push_back(novo_elemento[e]);
+        }
+        matriz.inicio.push_back((int)matriz.indices.size());
+        for (int p = grafo.inicio[j]; p < grafo.inicio[j + 1]; ++p) {
+            if (!ativo[grafo.vizinhos[p]]) continue;
+            conflitos.vizinhos.push_back(novo_subconjunto[grafo.vizinhos[p]]);
+            conflitos.penalidades.push_back(grafo.penalidades[p]);
+        }
+        conflitos.inicio.push_back((int)conflitos.vizinhos.size());
+    }
+
+    MatrizCSR<int>& lista = reduzida.lista_incidencia;
+    lista.inicio.assign(1, 0);
+    for (int e = 0; e < m; ++e) {
+        if (resolvido[e]) continue;
+        for (int j : original.lista_incidencia[e]) {
+            if (ativo[j]) lista.indices.push_back(novo_subconjunto[j]);
+        }
+        lista.inicio.push_back((int)lista.indices.size());
+    }
+
+    construir_incidencia_bits(reduzida);
+    especializar_instancia(reduzida);
+    return true;
+}
+
+std::set<int> solucao_original(const ReducaoInstancia& reducao, const std::set<int>& solucao_reduzida) {
+    std::set<int> solucao(reducao.fixados.begin(), reducao.fixados.end());
+    for (int j : solucao_reduzida) solucao.insert(reducao.originais[j]);
+    return solucao;
+}
+
+void restaurar_resultado(const ReducaoInstancia& reducao, ResultadoBRKGA& resultado) {
+    resultado.solucao = solucao_original(reducao, resultado.solucao);
+    resultado.custo += reducao.custo_fixo;
+    resultado.custo_antes_busca_local += reducao.custo_fixo;
+    for (PontoConvergencia& ponto : resultado.convergencia) ponto.melhor += reducao.custo_fixo;
+    for (RegistroGeracao& registro : resultado.rastro) registro.melhor += reducao.custo_fixo;
+}
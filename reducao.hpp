@@ -0,0 +1,47 @@
+#ifndef REDUCAO_HPP
+#define REDUCAO_HPP
+
+#include "scp_cs_data.hpp"
+#include "brkga.hpp"
+#include <set>
+#include <vector>
+
+// Correspondencia entre a instancia reduzida e a original
+struct ReducaoInstancia {
+    std::vector<int> originais; //subconjunto da reduzida -> subconjunto da original
+    std::vector<int> fixados;   //subconjuntos da original presentes em toda solucao (unica cobertura de algum elemento)
+    double custo_fixo = 0.0;    //custos dos fixados somados as penalidades entre eles
+
+    //estatisticas da reducao
+    int subconjuntos_originais = 0;
+    int elementos_originais = 0;
+    int elementos_implicados = 0; //elementos cobertos sempre que outro elemento é coberto
+    int removidos_vazios = 0;     //sem elementos a cobrir depois das fixacoes e implicacoes
+    int removidos_dominados = 0;
+    int rodadas = 0;              //passadas ate nenhuma regra se aplicar
+    bool custo_excedido = false;  //a reducao foi descartada: o custo ajustado de algum subconjunto passou de INT_MAX
+};
+
+// Reduz a instancia (com os conflitos ja construidos para o seu k) antes do BRKGA, repetindo ate nao haver mudanca:
+//  - um elemento coberto por um unico subconjunto restante fixa esse subconjunto na solucao: os elementos que ele
+//    cobre saem da instancia e as suas penalidades com os subconjuntos restantes passam para o custo deles;
+//  - um elemento f cujos subconjuntos restantes incluem todos os que cobrem outro elemento e sai da instancia
+//    (cobrir e ja cobre f);
+//  - um subconjunto que nao cobre mais nenhum elemento é removido;
+//  - um subconjunto a é removido se algum restante b cobre todos os elementos de a, custa no maximo o mesmo
+//    e tem, com cada outro subconjunto restante, penalidade no maximo igual a de a (trocar a por b em qualquer
+//    solucao nao aumenta o custo; entre subconjuntos equivalentes, o primeiro visitado é o removido).
+// Toda solucao da reduzida, somada aos fixados, é solucao da original com custo = custo na reduzida + custo_fixo,
+// e a reducao preserva ao menos uma solucao otima.
+// Retorna false (sem alterar reduzida) se nada foi removido ou se os custos ajustados nao cabem em int
+// (reducao.custo_excedido distingue os dois casos).
+bool reduzir_instancia(const SCPCSInstance& original, SCPCSInstance& reduzida, ReducaoInstancia& reducao);
+
+// Solucao da original correspondente a uma solucao da reduzida (inclui os fixados)
+std::set<int> solucao_original(const ReducaoInstancia& reducao, const std::set<int>& solucao_reduzida);
+
+// Converte para a instancia original o resultado de uma execucao na reduzida: a solucao e todos os custos
+// (final, antes da busca local, curvas de convergencia e rastro)
+void restaurar_resultado(const ReducaoInstancia& reducao, ResultadoBRKGA& resultado);
+
+#endif // REDUCAO_HPP
@@ -4,59 +4,154 @@
 #include <sstream>
 #include <set>
 #include <cmath>
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <climits>
+#include <filesystem>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
+double GrafoConflitos::penalidade(int i, int j) const {
+    auto ini = vizinhos.begin() + inicio[i];
+    auto fim = vizinhos.begin() + inicio[i + 1];
+    auto it = std::lower_bound(ini, fim, j);
+    if (it != fim && *it == j) {
+        return penalidades[it - vizinhos.begin()];
+    }
+    return 0.0;
+}
+
+size_t GrafoConflitos::memoria_bytes() const {
+    return inicio.capacity() * sizeof(int)
+         + vizinhos.capacity() * sizeof(int)
+         + penalidades.capacity() * sizeof(double);
+}
+
+//Arquivo mapeado em memoria (somente leitura), usado pelos leitores de texto e binario
+//em sistemas sem mmap o conteudo é copiado para um buffer
+class ArquivoMapeado {
+public:
+    explicit ArquivoMapeado(const std::string& nome_arquivo) {
+#ifdef _WIN32
+        ifstream arquivo(nome_arquivo, ios::binary);
+        if (!arquivo.is_open()) return;
+        buffer.assign(istreambuf_iterator<char>(arquivo), istreambuf_iterator<char>());
+        inicio = buffer.data();
+        tamanho_bytes = buffer.size();
+        valido = true;
+#else
+        descritor = open(nome_arquivo.c_str(), O_RDONLY);
+        if (descritor < 0) return;
+        struct stat info;
+        if (fstat(descritor, &info) != 0) return;
+        tamanho_bytes = (size_t)info.st_size;
+        valido = true;
+        if (tamanho_bytes == 0) return; //mmap nao aceita tamanho 0
+        void* mapa = mmap(nullptr, tamanho_bytes, PROT_READ, MAP_PRIVATE, descritor, 0);
+        if (mapa == MAP_FAILED) {
+            valido = false;
+            return;
+        }
+        madvise(mapa, tamanho_bytes, MADV_SEQUENTIAL);
+        inicio = static_cast<const char*>(mapa);
+#endif
+    }
+
+    ~ArquivoMapeado() {
+#ifndef _WIN32
+        if (inicio != nullptr) munmap(const_cast<char*>(inicio), tamanho_bytes);
+        if (descritor >= 0) close(descritor);
+#endif
+    }
+
+    ArquivoMapeado(const ArquivoMapeado&) = delete;
+    ArquivoMapeado& operator=(const ArquivoMapeado&) = delete;
+
+    bool aberto() const { return valido; }
+    const char* dados() const { return inicio; }
+    size_t tamanho() const { return tamanho_bytes; }
+
+private:
+    const char* inicio = nullptr;
+    size_t tamanho_bytes = 0;
+    bool valido = false;
+#ifdef _WIN32
+    std::string buffer;
+#else
+    int descritor = -1;
+#endif
+};
+
+//leitor de inteiros separados por espacos/quebras de linha diretamente sobre o arquivo mapeado
+//(std::from_chars nao aloca nem depende de locale)
+struct LeitorInteiros {
+    const char* atual;
+    const char* fim;
+
+    bool proximo(int& valor) {
+        while (atual < fim && (*atual == ' ' || *atual == '\n' || *atual == '\r' || *atual == '\t')) {
+            ++atual;
+        }
+        auto [ptr, erro] = std::from_chars(atual, fim, valor);
+        if (erro != std::errc()) return false;
+        atual = ptr;
+        return true;
+    }
+};
+
 bool ler_instancia_scpcs(const std::string& nome_arquivo, SCPCSInstance& instancia, int k) {
-    ifstream arquivo(nome_arquivo);
-    if (!arquivo.is_open()) {
+    ArquivoMapeado arquivo(nome_arquivo);
+    if (!arquivo.aberto()) {
         cerr << "Erro ao abrir o arquivo: " << nome_arquivo << endl;
         return false;
     }
+    LeitorInteiros leitor{arquivo.dados(), arquivo.dados() + arquivo.tamanho()};
 
     instancia.conflict_threshold = k;
-    string linha;
     
     //Leitura da primeira linha: m (numero de elementos) e n (numero de subconjuntos)
-    if (!getline(arquivo, linha)) {
+    if (!leitor.proximo(instancia.num_elementos) || !leitor.proximo(instancia.num_subconjuntos)) {
         cerr << "Erro: Arquivo vazio ou nao foi possivel ler a primeira linha (m e n)." << endl;
         return false;
     }
-    stringstream ss_mn(linha);
-    ss_mn >> instancia.num_elementos >> instancia.num_subconjuntos;
 
     int n = instancia.num_subconjuntos;
     int m = instancia.num_elementos;
     
     //Inicializa estruturas com base em n e m
     instancia.custos.resize(n); //Vetor de custos c_j
-    instancia.matriz_incidencia.resize(n); //Matriz de Incidência (elementos na linha j são cobertos pelo subconjunto j)
-    instancia.lista_incidencia.resize(m); //Lista de Incidência (elementos na linha i são os subconjuntos que cobrem o elemento i)
-
-    // Cria uma string para consumir todos os custos e IDs.
-    string buffer_dados;
-    while (getline(arquivo, linha)) {
-        buffer_dados += linha;
-        buffer_dados += " "; //Espaco para separar números entre linhas
-    }
-    
-    stringstream ss_buffer(buffer_dados);
 
     //Leitura dos custos (c_j)
-    //O ss_buffer ignora quebras de linha e espaços duplos
+    //o leitor ignora quebras de linha e espaços duplos
     for (int j = 0; j < n; ++j) {
-        if (!(ss_buffer >> instancia.custos[j])) {
+        if (!leitor.proximo(instancia.custos[j])) {
             cerr << "Erro: Arquivo terminou ou formato incorreto durante a leitura dos " << n << " custos." << endl;
             return false;
         }
     }
 
+    //a Lista de Incidência (elementos na linha i são os subconjuntos que cobrem o elemento i) é montada
+    //diretamente no formato CSR, pois o arquivo é organizado por elemento
+    MatrizCSR<int>& lista = instancia.lista_incidencia;
+    lista.inicio.assign(1, 0);
+    lista.indices.clear();
+
     //leitura das linhas de incidencia
     for (int i = 0; i < m; ++i) {
         int num_coberturas;
         
         //le o número de subconjuntos que cobrem o elemento i
-        if (!(ss_buffer >> num_coberturas)) {
+        if (!leitor.proximo(num_coberturas)) {
             cerr << "Erro: Faltam dados de 'num_coberturas' para o elemento " << i + 1 << endl;
             return false;
         }
@@ -65,39 +160,242 @@ bool ler_instancia_scpcs(const std::string& nome_arquivo, SCPCSInstance& instanc
         //percorre a lista de IDs de subconjunto (num_coberturas vezes)
         for (int k_id = 0; k_id < num_coberturas; ++k_id) {
             
-            if (!(ss_buffer >> subconjunto_id_1)) {
+            if (!leitor.proximo(subconjunto_id_1)) {
                 cerr << "Erro: Arquivo terminou ou formato incorreto durante a leitura dos IDs para o elemento " << i + 1 << endl;
                 return false;
             }
 
             //arquivo é lido em base 1 e convertido para base 0
             int subconjunto_id_0 = subconjunto_id_1 - 1;
-            int elemento_id_0 = i;
-            
+
             //verificar se os ids estao no limite estabelecido
             if (subconjunto_id_0 < 0 || subconjunto_id_0 >= n) {
                  cerr << "Erro de índice: ID de subconjunto (" << subconjunto_id_1 << ") fora dos limites (1 a " << n << "). SEGFUALT em indice " << subconjunto_id_0 << "." << endl;
                  return false;
             }
 
-            //construcao da matriz incidencia
-            instancia.matriz_incidencia[subconjunto_id_0].insert(elemento_id_0); 
-            instancia.lista_incidencia[elemento_id_0].push_back(subconjunto_id_0);
+            lista.indices.push_back(subconjunto_id_0);
         }
+
+        //ordena a linha do elemento i e descarta IDs repetidos
+        auto inicio_linha = lista.indices.begin() + lista.inicio[i];
+        std::sort(inicio_linha, lista.indices.end());
+        lista.indices.erase(std::unique(inicio_linha, lista.indices.end()), lista.indices.end());
+        lista.inicio.push_back((int)lista.indices.size());
     }
 
+    //a Matriz de Incidência (elementos na linha j são cobertos pelo subconjunto j) é a transposta da lista:
+    //primeiro conta a cardinalidade de cada subconjunto, depois distribui os elementos em ordem crescente
+    MatrizCSR<int>& matriz = instancia.matriz_incidencia;
+    matriz.inicio.assign(n + 1, 0);
+    for (int s : lista.indices) {
+        matriz.inicio[s + 1]++;
+    }
+    for (int j = 0; j < n; ++j) {
+        matriz.inicio[j + 1] += matriz.inicio[j];
+    }
+    matriz.indices.resize(lista.indices.size());
+    vector<int> proxima_posicao(matriz.inicio.begin(), matriz.inicio.end() - 1);
+    for (int i = 0; i < m; ++i) {
+        for (int s : lista[i]) {
+            matriz.indices[proxima_posicao[s]++] = i;
+        }
+    }
+    lista.indices.shrink_to_fit();
+
+    construir_incidencia_bits(instancia);
+
     std::cout << "Leitura do arquivo texto concluida com sucesso. Elementos (m): " << instancia.num_elementos 
          << ", Subconjuntos (n): " << instancia.num_subconjuntos << endl;
+    std::cout << "Memoria da instancia (incidencia CSR): "
+              << (matriz.memoria_bytes() + lista.memoria_bytes()) / 1024.0 << " KB";
+    if (!instancia.incidencia_bits.vazia()) {
+        std::cout << ", incidencia em bits: " << instancia.incidencia_bits.memoria_bytes() / 1024.0 << " KB";
+    }
+    std::cout << endl;
     
     return true;
 }
 
-void calcular_custos_conflito(SCPCSInstance& instancia, int k) {
-    instancia.conflict_threshold = k;
+//cardinalidade media minima, em palavras por linha, para usar a incidencia em bits: com popcount em hardware
+//a contagem em bits ja compensa com uma palavra por elemento; o popcount portavel so compensa nas instancias bem densas
+#if defined(__POPCNT__) || defined(__AVX2__) || defined(__aarch64__)
+#define FATOR_DENSIDADE_BITS 1.0
+#else
+#define FATOR_DENSIDADE_BITS 8.0
+#endif
+#define MEMORIA_MAXIMA_BITS (256u << 20) //limite da matriz de bits (bytes)
+
+void construir_incidencia_bits(SCPCSInstance& instancia) {
+    MatrizBits& bits = instancia.incidencia_bits;
+    int m = instancia.num_elementos;
+    int n = instancia.num_subconjuntos;
+    int palavras = (m + 63) / 64;
+    palavras = (palavras + MatrizBits::PALAVRAS_BLOCO - 1) / MatrizBits::PALAVRAS_BLOCO * MatrizBits::PALAVRAS_BLOCO;
+
+    //a contagem esparsa le |S_j| posicoes espalhadas da cobertura e a densa le palavras_por_linha palavras contiguas
+    //(varias por instrucao), entao a densa é usada quando a cardinalidade media passa de FATOR_DENSIDADE_BITS palavras
+    double cardinalidade_media = n > 0 ? (double)instancia.matriz_incidencia.indices.size() / n : 0.0;
+    bool densa = n > 0 && cardinalidade_media >= FATOR_DENSIDADE_BITS * palavras &&
+                 (size_t)n * palavras * sizeof(uint64_t) <= MEMORIA_MAXIMA_BITS;
+    if (!densa) {
+        bits.palavras_por_linha = 0;
+        bits.palavras.clear();
+        bits.palavras.shrink_to_fit();
+        return;
+    }
+    bits.palavras_por_linha = palavras;
+    bits.palavras.assign((size_t)n * palavras, 0);
+    for (int j = 0; j < n; ++j) {
+        uint64_t* linha = bits.palavras.data() + (size_t)j * palavras;
+        for (int e : instancia.matriz_incidencia[j]) {
+            linha[e >> 6] |= 1ULL << (e & 63);
+        }
+    }
+}
+
+#define DENSIDADE_MINIMA_CONFLITOS_DENSOS 0.25 //fracao dos pares em conflito a partir da qual a matriz densa é usada
+#define MEMORIA_MAXIMA_CONFLITOS_DENSOS (128u << 20) //limite da matriz densa de penalidades (bytes)
+
+size_t RepresentacaoEspecializada::memoria_bytes() const {
+    return matriz_incidencia16.memoria_bytes() + lista_incidencia16.memoria_bytes() +
+           vizinhos16.capacity() * sizeof(uint16_t) + penalidades_inteiras.capacity() * sizeof(int32_t) +
+           conflitos_densos_inteiros.capacity() * sizeof(int32_t) + conflitos_densos_reais.capacity() * sizeof(double);
+}
+
+static void compactar_indices(const MatrizCSR<int>& origem, MatrizCSR<uint16_t>& destino) {
+    destino.inicio = origem.inicio;
+    destino.indices.assign(origem.indices.begin(), origem.indices.end());
+}
+
+//custo inteiro: penalidades inteiras e, para cada subconjunto, o custo somado a todas as suas penalidades
+//cabe em int32_t (é o maior valor que a penalidade acumulada de um candidato pode atingir no decodificador)
+static bool custo_cabe_em_inteiro(const SCPCSInstance& instancia) {
+    const GrafoConflitos& grafo = instancia.conflitos;
+    bool tem_grafo = (int)grafo.inicio.size() == instancia.num_subconjuntos + 1;
+    for (int j = 0; j < instancia.num_subconjuntos; ++j) {
+        double limite = instancia.custos[j];
+        for (int p = tem_grafo ? grafo.inicio[j] : 0; tem_grafo && p < grafo.inicio[j + 1]; ++p) {
+            double penalidade = grafo.penalidades[p];
+            if (penalidade != std::floor(penalidade)) return false;
+            limite += penalidade;
+        }
+        if (limite > (double)INT32_MAX || limite < (double)INT32_MIN) return false;
+    }
+    return true;
+}
+
+static size_t memoria_conflitos_densos(const SCPCSInstance& instancia, TipoCusto custo) {
+    size_t n = (size_t)instancia.num_subconjuntos;
+    return n * n * (custo == CUSTO_INTEIRO ? sizeof(int32_t) : sizeof(double));
+}
+
+VarianteDecodificador escolher_variante(const SCPCSInstance& instancia) {
+    int n = instancia.num_subconjuntos;
+    int m = instancia.num_elementos;
+    const GrafoConflitos& grafo = instancia.conflitos;
+    VarianteDecodificador variante;
+    variante.custo = custo_cabe_em_inteiro(instancia) ? CUSTO_INTEIRO : CUSTO_REAL;
+    variante.indices = (n <= 65536 && m <= 65536) ? INDICES_16 : INDICES_32;
+
+    //a matriz densa troca a dispersao do CSR por uma soma contigua de n penalidades a cada selecao
+    double densidade = n > 1 ? (double)grafo.vizinhos.size() / ((double)n * (n - 1)) : 0.0;
+    if ((int)grafo.inicio.size() != n + 1 || grafo.vizinhos.empty()) {
+        variante.conflitos = CONFLITOS_NENHUM;
+    } else if (densidade >= DENSIDADE_MINIMA_CONFLITOS_DENSOS &&
+               memoria_conflitos_densos(instancia, variante.custo) <= MEMORIA_MAXIMA_CONFLITOS_DENSOS) {
+        variante.conflitos = CONFLITOS_DENSOS;
+    } else {
+        variante.conflitos = CONFLITOS_ESPARSOS;
+    }
+    return variante;
+}
+
+bool variante_suportada(const SCPCSInstance& instancia, const VarianteDecodificador& variante) {
+    int n = instancia.num_subconjuntos;
+    const GrafoConflitos& grafo = instancia.conflitos;
+    bool tem_grafo = (int)grafo.inicio.size() == n + 1;
+    if (variante.custo == CUSTO_INTEIRO && !custo_cabe_em_inteiro(instancia)) return false;
+    if (variante.indices == INDICES_16 && (n > 65536 || instancia.num_elementos > 65536)) return false;
+    switch (variante.conflitos) {
+        case CONFLITOS_NENHUM: return !tem_grafo || grafo.vizinhos.empty(); //ignoraria as penalidades
+        case CONFLITOS_DENSOS:
+            return tem_grafo && memoria_conflitos_densos(instancia, variante.custo) <= MEMORIA_MAXIMA_CONFLITOS_DENSOS;
+        default: return tem_grafo;
+    }
+}
+
+void especializar_instancia(SCPCSInstance& instancia) {
+    especializar_instancia(instancia, escolher_variante(instancia));
+}
+
+bool especializar_instancia(SCPCSInstance& instancia, const VarianteDecodificador& variante) {
+    if (!variante_suportada(instancia, variante)) return false;
+    const GrafoConflitos& grafo = instancia.conflitos;
     int n = instancia.num_subconjuntos;
+    bool inteiro = variante.custo == CUSTO_INTEIRO;
+    RepresentacaoEspecializada& especializada = instancia.especializada;
+    especializada = RepresentacaoEspecializada(); //libera as estruturas da escolha anterior
+    instancia.variante = variante;
+
+    if (variante.indices == INDICES_16) {
+        compactar_indices(instancia.matriz_incidencia, especializada.matriz_incidencia16);
+        compactar_indices(instancia.lista_incidencia, especializada.lista_incidencia16);
+        if (variante.conflitos == CONFLITOS_ESPARSOS) {
+            especializada.vizinhos16.assign(grafo.vizinhos.begin(), grafo.vizinhos.end());
+        }
+    }
+    if (variante.conflitos == CONFLITOS_ESPARSOS && inteiro) {
+        especializada.penalidades_inteiras.assign(grafo.penalidades.begin(), grafo.penalidades.end());
+    }
+    if (variante.conflitos == CONFLITOS_DENSOS) {
+        if (inteiro) especializada.conflitos_densos_inteiros.assign((size_t)n * n, 0);
+        else especializada.conflitos_densos_reais.assign((size_t)n * n, 0.0);
+        for (int j = 0; j < n; ++j) {
+            for (int p = grafo.inicio[j]; p < grafo.inicio[j + 1]; ++p) {
+                size_t posicao = (size_t)j * n + grafo.vizinhos[p];
+                if (inteiro) especializada.conflitos_densos_inteiros[posicao] = (int32_t)grafo.penalidades[p];
+                else especializada.conflitos_densos_reais[posicao] = grafo.penalidades[p];
+            }
+        }
+    }
+    return true;
+}
+
+std::string descrever_variante(const VarianteDecodificador& variante) {
+    std::string descricao = variante.conflitos == CONFLITOS_NENHUM ? "sem conflitos"
+                          : variante.conflitos == CONFLITOS_DENSOS ? "conflitos densos" : "conflitos esparsos";
+    descricao += variante.indices == INDICES_16 ? ", indices de 16 bits" : ", indices de 32 bits";
+    descricao += variante.custo == CUSTO_INTEIRO ? ", custo inteiro" : ", custo real";
+    return descricao;
+}
 
-    //redimensiona e inicializa a Matriz de Conflitos (todos a 0.0)
-    instancia.matriz_conflitos.resize(n, vector<double>(n, 0.0));
+bool interpretar_variante(const std::string& texto, VarianteDecodificador& variante) {
+    std::istringstream entrada(texto);
+    std::string conflitos, indices, custo, sobra;
+    if (!std::getline(entrada, conflitos, ',') || !std::getline(entrada, indices, ',') || !std::getline(entrada, custo, ',') ||
+        std::getline(entrada, sobra)) {
+        return false;
+    }
+    if (conflitos == "nenhum") variante.conflitos = CONFLITOS_NENHUM;
+    else if (conflitos == "esparsos") variante.conflitos = CONFLITOS_ESPARSOS;
+    else if (conflitos == "densos") variante.conflitos = CONFLITOS_DENSOS;
+    else return false;
+    if (indices == "16") variante.indices = INDICES_16;
+    else if (indices == "32") variante.indices = INDICES_32;
+    else return false;
+    if (custo == "inteiro") variante.custo = CUSTO_INTEIRO;
+    else if (custo == "real") variante.custo = CUSTO_REAL;
+    else return false;
+    return true;
+}
+
+size_t IntersecoesSubconjuntos::memoria_bytes() const {
+    return inicio.capacity() * sizeof(int) + vizinhos.capacity() * sizeof(int) + tamanhos.capacity() * sizeof(int);
+}
+
+void calcular_intersecoes(const SCPCSInstance& instancia, int k_minimo, IntersecoesSubconjuntos& intersecoes) {
+    int n = instancia.num_subconjuntos;
 
     double max_ratio = 0.0;
     
@@ -114,44 +412,305 @@ void calcular_custos_conflito(SCPCSInstance& instancia, int k) {
     }
     
     //a maior relacao custo/cardinalidade representa o custo de conflito unitario
-    int coeff = max(1, (int)round(max_ratio)); 
-    
-    //iteração sobre todos os pares de subconjuntos (i, j) para calcular os custos de conflito
-    for (int i = 0; i < n; ++i) {
-        for (int j = i + 1; j < n; ++j) {
-            
-            const std::set<int>& sub_i = instancia.matriz_incidencia[i];
-            const std::set<int>& sub_j = instancia.matriz_incidencia[j];
+    intersecoes.custo_unitario = max(1, (int)round(max_ratio));
+    intersecoes.k_minimo = k_minimo;
 
-            //calcular quantos elementos os dois subconjuntos têm em comum
-            int intersection_size = 0;
-            
-            //verifica quais elementos do menor conjunto estão no maior
-            if (sub_i.size() < sub_j.size()) {
-            for (int elemento : sub_i) {
-                if (sub_j.count(elemento)) {
-                    intersection_size++;
+    //cada linha i é construida de forma independente a partir da lista de incidencia:
+    //para cada elemento e de i, todo subconjunto s que cobre e recebe +1 em comuns[s],
+    //de modo que ao final comuns[s] é o tamanho da intersecao entre i e s
+    //(somente os pares que compartilham algum elemento sao visitados, sem comparar conjuntos)
+    vector<vector<pair<int, int>>> adjacencia(n);
+
+    auto construir_linhas = [&](int linha_inicio, int linha_fim) {
+        vector<int> comuns(n, 0); //contador de elementos em comum (reaproveitado entre linhas)
+        vector<int> tocados;      //subconjuntos com comuns > 0 na linha atual
+        tocados.reserve(n);
+
+        for (int i = linha_inicio; i < linha_fim; ++i) {
+            for (int elemento : instancia.matriz_incidencia[i]) {
+                for (int s : instancia.lista_incidencia[elemento]) {
+                    if (s != i && comuns[s]++ == 0) {
+                        tocados.push_back(s);
+                    }
                 }
             }
-            } else {
-                for (int elemento : sub_j) {
-                if (sub_i.count(elemento)) {
-                    intersection_size++;
+
+            //se k < 0 ate pares sem elementos em comum estao em conflito, entao todos os subconjuntos sao candidatos
+            if (k_minimo < 0) {
+                tocados.clear();
+                for (int s = 0; s < n; ++s) {
+                    if (s != i) tocados.push_back(s);
                 }
+            }
+            //mantem cada linha ordenada por indice (requisito do formato CSR)
+            std::sort(tocados.begin(), tocados.end());
+
+            for (int s : tocados) {
+                //somente os pares que estao em conflito para algum k >= k_minimo sao guardados
+                if (comuns[s] > k_minimo) {
+                    adjacencia[i].push_back({s, comuns[s]});
                 }
+                comuns[s] = 0;
             }
-            
+            tocados.clear();
+        }
+    };
+
+    //as linhas sao divididas em blocos contiguos, um por thread
+    int num_threads = std::max(1, std::min(n, (int)std::thread::hardware_concurrency()));
+    int tamanho_bloco = (n + num_threads - 1) / num_threads;
+    std::vector<std::future<void>> futuros;
+    for (int t = 0; t < num_threads; ++t) {
+        int linha_inicio = t * tamanho_bloco;
+        int linha_fim = std::min(n, linha_inicio + tamanho_bloco);
+        if (linha_inicio >= linha_fim) break;
+        futuros.push_back(std::async(std::launch::async, construir_linhas, linha_inicio, linha_fim));
+    }
+    for (auto& futuro : futuros) {
+        futuro.get();
+    }
+
+    //compacta a lista de adjacencia no formato CSR
+    intersecoes.inicio.assign(n + 1, 0);
+    for (int j = 0; j < n; ++j) {
+        intersecoes.inicio[j + 1] = intersecoes.inicio[j] + (int)adjacencia[j].size();
+    }
+    intersecoes.vizinhos.clear();
+    intersecoes.tamanhos.clear();
+    intersecoes.vizinhos.reserve(intersecoes.inicio[n]);
+    intersecoes.tamanhos.reserve(intersecoes.inicio[n]);
+    for (int j = 0; j < n; ++j) {
+        for (const auto& [vizinho, tamanho] : adjacencia[j]) {
+            intersecoes.vizinhos.push_back(vizinho);
+            intersecoes.tamanhos.push_back(tamanho);
+        }
+        vector<pair<int, int>>().swap(adjacencia[j]); //libera a linha assim que ela é copiada
+    }
+}
+
+void aplicar_conflitos_k(SCPCSInstance& instancia, const IntersecoesSubconjuntos& intersecoes, int k) {
+    instancia.conflict_threshold = k;
+    int n = instancia.num_subconjuntos;
+    double coeff = intersecoes.custo_unitario;
+
+    //primeira passada: quantos pares de cada linha ficam em conflito; segunda: copia os pares
+    //(as linhas das intersecoes ja estao ordenadas por indice, entao as do grafo tambem ficam)
+    GrafoConflitos& grafo = instancia.conflitos;
+    grafo.inicio.assign(n + 1, 0);
+    for (int j = 0; j < n; ++j) {
+        int em_conflito = 0;
+        for (int p = intersecoes.inicio[j]; p < intersecoes.inicio[j + 1]; ++p) {
+            if (intersecoes.tamanhos[p] > k) em_conflito++;
+        }
+        grafo.inicio[j + 1] = grafo.inicio[j] + em_conflito;
+    }
+    grafo.vizinhos.resize(grafo.inicio[n]);
+    grafo.penalidades.resize(grafo.inicio[n]);
+    for (int j = 0; j < n; ++j) {
+        int destino = grafo.inicio[j];
+        for (int p = intersecoes.inicio[j]; p < intersecoes.inicio[j + 1]; ++p) {
             //o valor de conflito é baseado em quantos elementos em comum excedem o limiar k
-            int conflict_size = max(0, intersection_size - k);
-        
+            int conflict_size = intersecoes.tamanhos[p] - k;
             if (conflict_size > 0) {
+                grafo.vizinhos[destino] = intersecoes.vizinhos[p];
                 //o custo unitario de conflito é multiplicado pelo número de conflitos
-                double conflict_cost = (double)coeff * conflict_size;
-                
-                //armazenar o custo na matriz
-                instancia.matriz_conflitos[i][j] = conflict_cost;
-                instancia.matriz_conflitos[j][i] = conflict_cost;
+                grafo.penalidades[destino] = coeff * conflict_size;
+                destino++;
             }
         }
     }
+    grafo.vizinhos.shrink_to_fit();
+    grafo.penalidades.shrink_to_fit();
+
+    //memoria do grafo esparso comparada com a matriz densa n x n que ele substitui
+    double memoria_densa_kb = (double)n * n * sizeof(double) / 1024.0;
+    std::cout << "Conflitos (k = " << k << "): " << grafo.num_pares() << " pares, "
+              << grafo.memoria_bytes() / 1024.0 << " KB (matriz densa: " << memoria_densa_kb << " KB)" << endl;
+
+    especializar_instancia(instancia);
+    std::cout << "Decodificador: " << descrever_variante(instancia.variante) << " ("
+              << instancia.especializada.memoria_bytes() / 1024.0 << " KB auxiliares)" << endl;
+}
+
+void calcular_custos_conflito(SCPCSInstance& instancia, int k) {
+    IntersecoesSubconjuntos intersecoes;
+    calcular_intersecoes(instancia, k, intersecoes);
+    aplicar_conflitos_k(instancia, intersecoes, k);
+}
+
+//cabecalho do arquivo binario da instancia (seguido pelos vetores, na ordem dos campos de tamanho)
+//os valores sao gravados na representacao nativa da maquina, entao o arquivo nao é portavel entre arquiteturas
+struct CabecalhoBinario {
+    char magica[8];
+    uint32_t versao;
+    int32_t num_elementos;
+    int32_t num_subconjuntos;
+    int32_t k;
+    uint64_t tam_lista;      //tamanho de lista_incidencia.indices (= matriz_incidencia.indices)
+    uint64_t tam_conflitos;  //tamanho de conflitos.vizinhos (= conflitos.penalidades)
+};
+
+static const char MAGICA_BINARIO[8] = {'S', 'C', 'P', 'C', 'S', 'B', 'I', 'N'};
+static const uint32_t VERSAO_BINARIO = 1;
+
+std::string nome_arquivo_binario(const std::string& nome_arquivo, int k) {
+    return nome_arquivo + ".k" + std::to_string(k) + ".bin";
+}
+
+template <typename T>
+static void gravar_vetor(ofstream& saida, const std::vector<T>& v) {
+    saida.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+}
+
+//o arquivo é gravado com outro nome e depois renomeado (rename é atomico), entao processos que leem o binario
+//ao mesmo tempo (lotes ou execucao distribuida com --cache) veem o arquivo antigo inteiro ou o novo inteiro
+bool salvar_instancia_binaria(const std::string& nome_binario, const SCPCSInstance& instancia) {
+    std::string nome_temporario = nome_binario + ".tmp" + std::to_string((long long)getpid());
+    ofstream saida(nome_temporario, ios::binary | ios::trunc);
+    if (!saida.is_open()) {
+        cerr << "Erro ao criar o arquivo binario: " << nome_temporario << endl;
+        return false;
+    }
+    CabecalhoBinario cabecalho;
+    std::memcpy(cabecalho.magica, MAGICA_BINARIO, sizeof(MAGICA_BINARIO));
+    cabecalho.versao = VERSAO_BINARIO;
+    cabecalho.num_elementos = instancia.num_elementos;
+    cabecalho.num_subconjuntos = instancia.num_subconjuntos;
+    cabecalho.k = instancia.conflict_threshold;
+    cabecalho.tam_lista = instancia.lista_incidencia.indices.size();
+    cabecalho.tam_conflitos = instancia.conflitos.vizinhos.size();
+    saida.write(reinterpret_cast<const char*>(&cabecalho), sizeof(cabecalho));
+
+    gravar_vetor(saida, instancia.custos);
+    gravar_vetor(saida, instancia.lista_incidencia.inicio);
+    gravar_vetor(saida, instancia.lista_incidencia.indices);
+    gravar_vetor(saida, instancia.matriz_incidencia.inicio);
+    gravar_vetor(saida, instancia.matriz_incidencia.indices);
+    gravar_vetor(saida, instancia.conflitos.inicio);
+    gravar_vetor(saida, instancia.conflitos.vizinhos);
+    gravar_vetor(saida, instancia.conflitos.penalidades);
+    saida.close();
+
+    std::error_code erro;
+    if (saida.fail()) {
+        cerr << "Erro ao gravar o arquivo binario: " << nome_temporario << endl;
+    } else {
+        std::filesystem::rename(nome_temporario, nome_binario, erro);
+        if (!erro) return true;
+        cerr << "Erro ao renomear o arquivo binario para " << nome_binario << ": " << erro.message() << endl;
+    }
+    std::filesystem::remove(nome_temporario, erro);
+    return false;
+}
+
+//copia "quantidade" valores do arquivo mapeado para o vetor, avancando o cursor
+template <typename T>
+static bool copiar_vetor(const char*& cursor, const char* fim, std::vector<T>& v, uint64_t quantidade) {
+    if (quantidade > (uint64_t)(fim - cursor) / sizeof(T)) return false; //sem estourar quantidade * sizeof(T)
+    size_t bytes = quantidade * sizeof(T);
+    v.resize(quantidade);
+    std::memcpy(v.data(), cursor, bytes);
+    cursor += bytes;
+    return true;
+}
+
+//CSR com num_linhas linhas: deslocamentos comecando em 0, crescentes e terminando no tamanho de indices,
+//e cada linha com indices estritamente crescentes em [0, limite)
+static bool csr_valida(const std::vector<int>& inicio, const std::vector<int>& indices, int num_linhas, int limite) {
+    if ((int)inicio.size() != num_linhas + 1 || inicio[0] != 0 || (size_t)inicio[num_linhas] != indices.size()) return false;
+    for (int linha = 0; linha < num_linhas; ++linha) {
+        if (inicio[linha + 1] < inicio[linha]) return false;
+        for (int p = inicio[linha]; p < inicio[linha + 1]; ++p) {
+            if (indices[p] < 0 || indices[p] >= limite) return false;
+            if (p > inicio[linha] && indices[p] <= indices[p - 1]) return false;
+        }
+    }
+    return true;
+}
+
+//confere um binario lido antes que o decodificador o use: tamanhos, deslocamentos, faixas dos indices e penalidades
+static bool instancia_binaria_valida(const SCPCSInstance& instancia) {
+    int m = instancia.num_elementos;
+    int n = instancia.num_subconjuntos;
+    const GrafoConflitos& grafo = instancia.conflitos;
+    if (!csr_valida(instancia.lista_incidencia.inicio, instancia.lista_incidencia.indices, m, n) ||
+        !csr_valida(instancia.matriz_incidencia.inicio, instancia.matriz_incidencia.indices, n, m) ||
+        !csr_valida(grafo.inicio, grafo.vizinhos, n, n)) {
+        return false;
+    }
+    for (double penalidade : grafo.penalidades) {
+        if (!std::isfinite(penalidade) || penalidade < 0) return false;
+    }
+    return true;
+}
+
+bool carregar_instancia_binaria(const std::string& nome_binario, SCPCSInstance& instancia, int k) {
+    ArquivoMapeado arquivo(nome_binario);
+    if (!arquivo.aberto() || arquivo.tamanho() < sizeof(CabecalhoBinario)) {
+        return false;
+    }
+    CabecalhoBinario cabecalho;
+    std::memcpy(&cabecalho, arquivo.dados(), sizeof(cabecalho));
+    if (std::memcmp(cabecalho.magica, MAGICA_BINARIO, sizeof(MAGICA_BINARIO)) != 0 ||
+        cabecalho.versao != VERSAO_BINARIO || cabecalho.k != k) {
+        return false;
+    }
+    int m = cabecalho.num_elementos;
+    int n = cabecalho.num_subconjuntos;
+    if (m <= 0 || n <= 0) {
+        cerr << "Erro: arquivo binario invalido (m = " << m << ", n = " << n << "): " << nome_binario << endl;
+        return false;
+    }
+
+    const char* cursor = arquivo.dados() + sizeof(cabecalho);
+    const char* fim = arquivo.dados() + arquivo.tamanho();
+    bool ok = copiar_vetor(cursor, fim, instancia.custos, n)
+           && copiar_vetor(cursor, fim, instancia.lista_incidencia.inicio, m + 1)
+           && copiar_vetor(cursor, fim, instancia.lista_incidencia.indices, cabecalho.tam_lista)
+           && copiar_vetor(cursor, fim, instancia.matriz_incidencia.inicio, n + 1)
+           && copiar_vetor(cursor, fim, instancia.matriz_incidencia.indices, cabecalho.tam_lista)
+           && copiar_vetor(cursor, fim, instancia.conflitos.inicio, n + 1)
+           && copiar_vetor(cursor, fim, instancia.conflitos.vizinhos, cabecalho.tam_conflitos)
+           && copiar_vetor(cursor, fim, instancia.conflitos.penalidades, cabecalho.tam_conflitos);
+    if (!ok) {
+        cerr << "Erro: arquivo binario truncado: " << nome_binario << endl;
+        instancia = SCPCSInstance();
+        return false;
+    }
+    instancia.num_elementos = m;
+    instancia.num_subconjuntos = n;
+    instancia.conflict_threshold = k;
+    if (!instancia_binaria_valida(instancia)) {
+        cerr << "Erro: arquivo binario corrompido (deslocamentos ou indices fora dos limites): " << nome_binario << endl;
+        instancia = SCPCSInstance();
+        return false;
+    }
+    construir_incidencia_bits(instancia);
+    especializar_instancia(instancia);
+    return true;
+}
+
+bool ler_instancia_com_cache(const std::string& nome_arquivo, SCPCSInstance& instancia, int k) {
+    std::string nome_binario = nome_arquivo_binario(nome_arquivo, k);
+
+    //o binario so é usado se for mais novo que o arquivo texto e valido; senao, o texto é lido e o binario regravado
+    std::error_code erro;
+    auto data_texto = std::filesystem::last_write_time(nome_arquivo, erro);
+    auto data_binario = std::filesystem::last_write_time(nome_binario, erro);
+    if (!erro && data_binario >= data_texto && carregar_instancia_binaria(nome_binario, instancia, k)) {
+        std::cout << "Instancia carregada do arquivo binario: " << nome_binario
+                  << " (m = " << instancia.num_elementos << ", n = " << instancia.num_subconjuntos
+                  << ", " << instancia.conflitos.num_pares() << " pares em conflito; decodificador: "
+                  << descrever_variante(instancia.variante) << ")" << endl;
+        return true;
+    }
+
+    if (!ler_instancia_scpcs(nome_arquivo, instancia, k)) {
+        return false;
+    }
+    calcular_custos_conflito(instancia, k);
+    if (salvar_instancia_binaria(nome_binario, instancia)) {
+        std::cout << "Arquivo binario gravado: " << nome_binario << endl;
+    }
+    return true;
 }
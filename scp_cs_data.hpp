@@ -2,26 +2,186 @@
 #define SCP_CS_DATA_HPP
 
 #include <iostream>
+#include <cstdint>
 #include <vector>
 #include <set>
 #include <string>
 
+// Intervalo somente-leitura [inicio, fim) sobre memoria contigua (ex: uma linha de uma MatrizCSR,
+// permitindo "for (int e : matriz[j])", ou os genes de um cromossomo sem copia-los)
+template <typename T>
+struct Intervalo {
+    const T* inicio_ = nullptr;
+    const T* fim_ = nullptr;
+
+    Intervalo() = default;
+    Intervalo(const T* inicio, const T* fim) : inicio_(inicio), fim_(fim) {}
+    Intervalo(const std::vector<T>& v) : inicio_(v.data()), fim_(v.data() + v.size()) {}
+
+    const T* begin() const { return inicio_; }
+    const T* end() const { return fim_; }
+    int size() const { return (int)(fim_ - inicio_); }
+    bool empty() const { return inicio_ == fim_; }
+    const T& operator[](int i) const { return inicio_[i]; }
+};
+
+// Matriz esparsa imutavel no formato CSR: a linha r ocupa indices[inicio[r] .. inicio[r+1]),
+// com os indices de cada linha ordenados de forma crescente e armazenados de forma contigua
+template <typename T>
+struct MatrizCSR {
+    std::vector<int> inicio;  // num_linhas + 1 deslocamentos
+    std::vector<T> indices;   // indices de coluna de todas as linhas, em sequencia
+
+    int num_linhas() const { return (int)inicio.size() - 1; }
+    Intervalo<T> operator[](int linha) const {
+        return {indices.data() + inicio[linha], indices.data() + inicio[linha + 1]};
+    }
+    size_t memoria_bytes() const { return inicio.capacity() * sizeof(int) + indices.capacity() * sizeof(T); }
+};
+
+// Grafo de Conflitos Esparso (CSR)
+// os vizinhos em conflito do subconjunto j ficam em vizinhos[inicio[j] .. inicio[j+1]),
+// ordenados por indice, e penalidades[p] é o custo de conflito do par (j, vizinhos[p])
+struct GrafoConflitos {
+    std::vector<int> inicio;          // n + 1 deslocamentos
+    std::vector<int> vizinhos;        // indices dos subconjuntos vizinhos
+    std::vector<double> penalidades;  // penalidade de cada aresta (mesma posicao de vizinhos)
+
+    int grau(int j) const { return inicio[j + 1] - inicio[j]; }
+
+    //retorna a penalidade do par (i, j), ou 0.0 se nao ha conflito (busca binaria na linha i)
+    double penalidade(int i, int j) const;
+
+    //numero de pares em conflito (cada par aparece duas vezes no CSR)
+    size_t num_pares() const { return vizinhos.size() / 2; }
+
+    //memoria ocupada pelos vetores do grafo, em bytes
+    size_t memoria_bytes() const;
+};
+
+// Incidencia densa: a linha j tem um bit por elemento (bit i da palavra i / 64 = elemento i coberto por j),
+// de modo que os elementos novos de um subconjunto sao contados com popcount(linha & ~cobertura)
+// palavras_por_linha é arredondado para um multiplo de PALAVRAS_BLOCO (as palavras extras ficam zeradas),
+// entao os lacos vetoriais do decodificador nao precisam tratar sobras
+struct MatrizBits {
+    static const int PALAVRAS_BLOCO = 4; //4 palavras de 64 bits = um registrador AVX2
+
+    int palavras_por_linha = 0;
+    std::vector<uint64_t> palavras; //num_linhas * palavras_por_linha
+
+    bool vazia() const { return palavras.empty(); }
+    const uint64_t* linha(int j) const { return palavras.data() + (size_t)j * palavras_por_linha; }
+    size_t memoria_bytes() const { return palavras.capacity() * sizeof(uint64_t); }
+};
+
+// Variante do decodificador e do calculo de custo, escolhida uma vez por instancia (ver especializar_instancia)
+// e instanciada em tempo de compilacao, de modo que os lacos internos nao testam o caso a cada iteracao
+enum ModeloConflitos {
+    CONFLITOS_NENHUM,    //nenhum par em conflito para o k: cobertura de conjuntos pura
+    CONFLITOS_ESPARSOS,  //grafo CSR (conflitos)
+    CONFLITOS_DENSOS     //matriz n x n de penalidades (grafos com grande parte dos pares em conflito)
+};
+enum LarguraIndices {
+    INDICES_32,  //vetores originais (int)
+    INDICES_16   //copias em uint16_t das incidencias e dos vizinhos (n e m ate 65536)
+};
+enum TipoCusto {
+    CUSTO_REAL,    //penalidades acumuladas em double
+    CUSTO_INTEIRO  //penalidades inteiras acumuladas em int32_t (custo de cada subconjunto com todos os conflitos cabe em 32 bits)
+};
+struct VarianteDecodificador {
+    ModeloConflitos conflitos = CONFLITOS_ESPARSOS;
+    LarguraIndices indices = INDICES_32;
+    TipoCusto custo = CUSTO_REAL;
+};
+
+// Estruturas auxiliares das variantes (somente as usadas pela variante escolhida ficam preenchidas)
+struct RepresentacaoEspecializada {
+    MatrizCSR<uint16_t> matriz_incidencia16;
+    MatrizCSR<uint16_t> lista_incidencia16;
+    std::vector<uint16_t> vizinhos16;           //conflitos.vizinhos em 16 bits
+    std::vector<int32_t> penalidades_inteiras;  //conflitos.penalidades em inteiros (mesma posicao)
+    std::vector<int32_t> conflitos_densos_inteiros; //matriz n x n de penalidades (diagonal zero)
+    std::vector<double> conflitos_densos_reais;
+
+    size_t memoria_bytes() const;
+};
+
 // Definição da Estrutura da Instância
 struct SCPCSInstance {
     int num_elementos;
     int num_subconjuntos;
     std::vector<int> custos;
-    
+
     // Matriz de Incidência (Direta): subconjunto -> {elementos que ele cobre}
-    std::vector<std::set<int>> matriz_incidencia;
-    
+    MatrizCSR<int> matriz_incidencia;
+
     // Lista de Incidência (Inversa): elemento -> {subconjuntos que o cobrem}
-    std::vector<std::vector<int>> lista_incidencia;
-    
-    // Matriz de Penalidades de Conflito (n x n)
-    std::vector<std::vector<double>> matriz_conflitos; 
-    int conflict_threshold; 
+    MatrizCSR<int> lista_incidencia;
+
+    // Penalidades de Conflito (somente os pares com conflito sao armazenados)
+    GrafoConflitos conflitos;
+    int conflict_threshold;
+
+    // Incidencia densa em bits, construida somente para instancias densas (vazia nas esparsas)
+    MatrizBits incidencia_bits;
+
+    // Variante do decodificador para esta instancia e k, e as estruturas que ela usa
+    VarianteDecodificador variante;
+    RepresentacaoEspecializada especializada;
 };
 bool ler_instancia_scpcs(const std::string& nome_arquivo, SCPCSInstance& instancia, int k);
 void calcular_custos_conflito(SCPCSInstance& instancia, int k);
-#endif // SCP_CS_DATA_H
\ No newline at end of file
+
+// Tamanhos das intersecoes entre os pares de subconjuntos, calculados uma unica vez para derivar
+// os conflitos de varios valores de k (em CSR, com as linhas ordenadas por indice)
+// somente os pares com intersecao maior que k_minimo sao guardados, pois sao os unicos em conflito para k >= k_minimo
+struct IntersecoesSubconjuntos {
+    int k_minimo = 0;
+    double custo_unitario = 1.0;  //custo de conflito por elemento em comum excedente (nao depende de k)
+    std::vector<int> inicio;      //n + 1 deslocamentos
+    std::vector<int> vizinhos;
+    std::vector<int> tamanhos;    //elementos em comum com o vizinho da mesma posicao
+
+    size_t memoria_bytes() const;
+};
+
+// Passada completa sobre os pares de subconjuntos (o que calcular_custos_conflito faz para um unico k)
+void calcular_intersecoes(const SCPCSInstance& instancia, int k_minimo, IntersecoesSubconjuntos& intersecoes);
+
+// Constroi o grafo de conflitos para k (k >= intersecoes.k_minimo) em tempo linear no numero de pares guardados
+// e escolhe a variante do decodificador para ele
+void aplicar_conflitos_k(SCPCSInstance& instancia, const IntersecoesSubconjuntos& intersecoes, int k);
+
+// Escolhe a representacao da cobertura usada pelo decodificador: constroi incidencia_bits quando a cardinalidade
+// media dos subconjuntos torna a contagem por popcount mais barata que percorrer os elementos (e a limpa caso contrario)
+// Chamada pelos leitores; deve ser chamada de novo se matriz_incidencia for alterada
+void construir_incidencia_bits(SCPCSInstance& instancia);
+
+// Escolhe a variante do decodificador a partir de n, m e do grafo de conflitos (modelo de conflitos,
+// largura dos indices e tipo do custo) e constroi as estruturas auxiliares dela
+// Chamada ao fim de calcular_custos_conflito e de carregar_instancia_binaria
+void especializar_instancia(SCPCSInstance& instancia);
+VarianteDecodificador escolher_variante(const SCPCSInstance& instancia);
+
+// Forca uma variante (ex: para comparar as variantes entre si); retorna false, sem alterar a instancia,
+// se ela nao produz os mesmos custos nesta instancia: custo inteiro com penalidades fracionarias ou acima de
+// 32 bits, indices de 16 bits com n ou m acima de 65536, CONFLITOS_NENHUM com pares em conflito, ou conflitos
+// esparsos/densos sem o grafo calculado (densos tambem respeitam o limite de memoria da matriz)
+bool especializar_instancia(SCPCSInstance& instancia, const VarianteDecodificador& variante);
+bool variante_suportada(const SCPCSInstance& instancia, const VarianteDecodificador& variante);
+
+std::string descrever_variante(const VarianteDecodificador& variante);
+// "<nenhum|esparsos|densos>,<32|16>,<real|inteiro>", ex: "esparsos,16,inteiro"
+bool interpretar_variante(const std::string& texto, VarianteDecodificador& variante);
+
+// Formato binario da instancia: vetores de incidencia e grafo de conflitos ja calculado para um k,
+// carregados com um unico mmap e sem nenhuma conversao de texto
+std::string nome_arquivo_binario(const std::string& nome_arquivo, int k);
+bool salvar_instancia_binaria(const std::string& nome_binario, const SCPCSInstance& instancia);
+bool carregar_instancia_binaria(const std::string& nome_binario, SCPCSInstance& instancia, int k);
+
+// Carrega o binario "<arquivo>.k<k>.bin" se ele existir e for mais novo que o texto; caso contrario
+// le o texto, calcula os conflitos e grava o binario para as proximas execucoes
+bool ler_instancia_com_cache(const std::string& nome_arquivo, SCPCSInstance& instancia, int k);
+#endif // SCP_CS_DATA_H
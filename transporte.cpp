@@ -0,0 +1,221 @@
+#include "transporte.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+#include <chrono>
+#include <thread>
+
+#ifndef _WIN32
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+// os sockets do modo distribuido so estao implementados para sistemas POSIX
+CanalSocket::~CanalSocket() {}
+bool CanalSocket::enviar(uint32_t, const std::vector<char>&) { return false; }
+bool CanalSocket::receber(Mensagem&) { return false; }
+bool CanalSocket::receber(Mensagem&, double) { return false; }
+void CanalSocket::encerrar_envio() {}
+ServidorCanais::~ServidorCanais() {}
+bool ServidorCanais::escutar(const std::string&) {
+    cerr << "Modo distribuido nao suportado neste sistema" << endl;
+    return false;
+}
+std::unique_ptr<Canal> ServidorCanais::aceitar(double) { return nullptr; }
+std::unique_ptr<Canal> conectar_canal(const std::string&, double) {
+    cerr << "Modo distribuido nao suportado neste sistema" << endl;
+    return nullptr;
+}
+
+#else
+
+//escreve/le exatamente "tamanho" bytes (as chamadas do sistema podem transferir menos de uma vez)
+static bool escrever_tudo(int descritor, const char* dados, size_t tamanho) {
+    while (tamanho > 0) {
+        ssize_t escritos = ::send(descritor, dados, tamanho, MSG_NOSIGNAL);
+        if (escritos <= 0) return false;
+        dados += escritos;
+        tamanho -= (size_t)escritos;
+    }
+    return true;
+}
+
+//espera o descritor ficar legivel (dados ou conexao pendente) por ate tempo_espera_s segundos
+static bool esperar_leitura(int descritor, double tempo_espera_s) {
+    auto limite = std::chrono::steady_clock::now() + std::chrono::duration<double>(tempo_espera_s);
+    while (true) {
+        auto restante = std::chrono::duration_cast<std::chrono::milliseconds>(limite - std::chrono::steady_clock::now());
+        pollfd evento{descritor, POLLIN, 0};
+        int prontos = ::poll(&evento, 1, (int)std::max<long long>(0, restante.count()));
+        if (prontos > 0) return true;
+        if (prontos == 0 || errno != EINTR) return false;
+    }
+}
+
+//com limite, cada leitura so é feita depois que o descritor fica legivel antes do limite
+static bool ler_tudo(int descritor, char* dados, size_t tamanho, const std::chrono::steady_clock::time_point* limite = nullptr) {
+    while (tamanho > 0) {
+        if (limite && !esperar_leitura(descritor, std::chrono::duration<double>(*limite - std::chrono::steady_clock::now()).count())) {
+            return false;
+        }
+        ssize_t lidos = ::recv(descritor, dados, tamanho, 0);
+        if (lidos <= 0) return false;
+        dados += lidos;
+        tamanho -= (size_t)lidos;
+    }
+    return true;
+}
+
+CanalSocket::~CanalSocket() {
+    if (descritor >= 0) close(descritor);
+}
+
+bool CanalSocket::enviar(uint32_t tipo, const std::vector<char>& carga) {
+    if (carga.size() > TAMANHO_MAXIMO_CARGA) return false; //o outro lado recusaria a mensagem
+    uint32_t cabecalho[2] = {tipo, (uint32_t)carga.size()};
+    std::lock_guard<std::mutex> trava(mutex_envio);
+    return escrever_tudo(descritor, reinterpret_cast<const char*>(cabecalho), sizeof(cabecalho)) &&
+           escrever_tudo(descritor, carga.data(), carga.size());
+}
+
+static bool receber_quadro(int descritor, Mensagem& mensagem, const std::chrono::steady_clock::time_point* limite) {
+    uint32_t cabecalho[2];
+    if (!ler_tudo(descritor, reinterpret_cast<char*>(cabecalho), sizeof(cabecalho), limite)) return false;
+    if (cabecalho[1] > TAMANHO_MAXIMO_CARGA) return false; //cabecalho corrompido ou de outro protocolo
+    mensagem.tipo = cabecalho[0];
+    mensagem.carga.resize(cabecalho[1]);
+    return ler_tudo(descritor, mensagem.carga.data(), mensagem.carga.size(), limite);
+}
+
+bool CanalSocket::receber(Mensagem& mensagem) {
+    return receber_quadro(descritor, mensagem, nullptr);
+}
+
+bool CanalSocket::receber(Mensagem& mensagem, double tempo_espera_s) {
+    auto limite = std::chrono::steady_clock::now() +
+                  std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(tempo_espera_s));
+    return receber_quadro(descritor, mensagem, &limite);
+}
+
+void CanalSocket::encerrar_envio() {
+    ::shutdown(descritor, SHUT_WR);
+}
+
+//endereco de socket a partir de "unix:<caminho>" ou "tcp:<host>:<porta>"
+struct EnderecoSocket {
+    int familia = AF_UNSPEC;
+    sockaddr_storage endereco{};
+    socklen_t tamanho = 0;
+    std::string caminho_unix;
+};
+
+static bool interpretar_endereco(const std::string& texto, EnderecoSocket& saida) {
+    if (texto.rfind("unix:", 0) == 0) {
+        saida.caminho_unix = texto.substr(5);
+        sockaddr_un endereco{};
+        if (saida.caminho_unix.empty() || saida.caminho_unix.size() >= sizeof(endereco.sun_path)) return false;
+        endereco.sun_family = AF_UNIX;
+        std::strncpy(endereco.sun_path, saida.caminho_unix.c_str(), sizeof(endereco.sun_path) - 1);
+        std::memcpy(&saida.endereco, &endereco, sizeof(endereco));
+        saida.tamanho = sizeof(endereco);
+        saida.familia = AF_UNIX;
+        return true;
+    }
+    if (texto.rfind("tcp:", 0) == 0) {
+        size_t separador = texto.rfind(':');
+        if (separador <= 4) return false;
+        std::string host = texto.substr(4, separador - 4);
+        std::string porta = texto.substr(separador + 1);
+
+        addrinfo dicas{};
+        dicas.ai_family = AF_INET;
+        dicas.ai_socktype = SOCK_STREAM;
+        addrinfo* resultado = nullptr;
+        if (getaddrinfo(host.c_str(), porta.c_str(), &dicas, &resultado) != 0 || resultado == nullptr) return false;
+        std::memcpy(&saida.endereco, resultado->ai_addr, resultado->ai_addrlen);
+        saida.tamanho = resultado->ai_addrlen;
+        saida.familia = AF_INET;
+        freeaddrinfo(resultado);
+        return true;
+    }
+    return false;
+}
+
+//desliga o algoritmo de Nagle: as mensagens de migracao sao pequenas e nao devem esperar
+static void configurar_tcp(int descritor, int familia) {
+    if (familia != AF_INET) return;
+    int ligado = 1;
+    setsockopt(descritor, IPPROTO_TCP, TCP_NODELAY, &ligado, sizeof(ligado));
+}
+
+ServidorCanais::~ServidorCanais() {
+    if (descritor >= 0) close(descritor);
+    if (!caminho_unix.empty()) unlink(caminho_unix.c_str());
+}
+
+bool ServidorCanais::escutar(const std::string& texto) {
+    EnderecoSocket endereco;
+    if (!interpretar_endereco(texto, endereco)) {
+        cerr << "Endereco invalido: " << texto << " (use unix:<caminho> ou tcp:<host>:<porta>)" << endl;
+        return false;
+    }
+    descritor = socket(endereco.familia, SOCK_STREAM, 0);
+    if (descritor < 0) return false;
+    if (endereco.familia == AF_UNIX) {
+        unlink(endereco.caminho_unix.c_str()); //socket deixado por uma execucao anterior
+        caminho_unix = endereco.caminho_unix;
+    } else {
+        int ligado = 1;
+        setsockopt(descritor, SOL_SOCKET, SO_REUSEADDR, &ligado, sizeof(ligado));
+    }
+    if (bind(descritor, reinterpret_cast<sockaddr*>(&endereco.endereco), endereco.tamanho) != 0 || listen(descritor, 64) != 0) {
+        cerr << "Erro ao escutar em " << texto << endl;
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<Canal> ServidorCanais::aceitar(double tempo_espera_s) {
+    if (!esperar_leitura(descritor, tempo_espera_s)) return nullptr;
+    int conexao = ::accept(descritor, nullptr, nullptr);
+    if (conexao < 0) return nullptr;
+    sockaddr_storage local{};
+    socklen_t tamanho = sizeof(local);
+    getsockname(conexao, reinterpret_cast<sockaddr*>(&local), &tamanho);
+    configurar_tcp(conexao, local.ss_family);
+    return std::unique_ptr<Canal>(new CanalSocket(conexao));
+}
+
+std::unique_ptr<Canal> conectar_canal(const std::string& texto, double tempo_espera_s) {
+    EnderecoSocket endereco;
+    if (!interpretar_endereco(texto, endereco)) {
+        cerr << "Endereco invalido: " << texto << " (use unix:<caminho> ou tcp:<host>:<porta>)" << endl;
+        return nullptr;
+    }
+    auto limite = std::chrono::steady_clock::now() + std::chrono::duration<double>(tempo_espera_s);
+    while (true) {
+        int descritor = socket(endereco.familia, SOCK_STREAM, 0);
+        if (descritor < 0) return nullptr;
+        if (::connect(descritor, reinterpret_cast<sockaddr*>(&endereco.endereco), endereco.tamanho) == 0) {
+            configurar_tcp(descritor, endereco.familia);
+            return std::unique_ptr<Canal>(new CanalSocket(descritor));
+        }
+        close(descritor);
+        if (std::chrono::steady_clock::now() >= limite) {
+            cerr << "Nao foi possivel conectar a " << texto << endl;
+            return nullptr;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef TRANSPORTE_HPP
+#define TRANSPORTE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Tipos das mensagens trocadas entre os processos do modo distribuido
+enum TipoMensagem : uint32_t {
+    MENSAGEM_OLA = 1,       //trabalhador -> coordenador: configuracao da execucao;
+                            //coordenador -> trabalhador: identificador do processo e inicio da execucao
+    MENSAGEM_MIGRANTES = 2, //melhores cromossomos de uma ilha
+    MENSAGEM_PARAR = 3,     //coordenador -> trabalhador: o tempo limite global acabou
+    MENSAGEM_SOLUCAO = 4    //trabalhador -> coordenador: melhor solucao do processo
+};
+
+// Maior carga aceita em uma mensagem (bem acima do resultado com rastreamento de uma execucao longa):
+// um cabecalho corrompido nao pode pedir uma alocacao arbitraria
+const uint32_t TAMANHO_MAXIMO_CARGA = 256u << 20;
+
+// Mensagem recebida: tipo e carga (bytes)
+struct Mensagem {
+    uint32_t tipo = 0;
+    std::vector<char> carga;
+};
+
+// Canal bidirecional de mensagens entre dois processos
+// o enquadramento é binario e compacto: cabecalho {tipo, tamanho da carga} (2 x uint32) seguido da carga;
+// os valores sao gravados na ordem de bytes da maquina (os processos rodam na mesma arquitetura)
+class Canal {
+public:
+    virtual ~Canal() = default;
+
+    //envia uma mensagem inteira (pode ser chamado por varias threads ao mesmo tempo)
+    virtual bool enviar(uint32_t tipo, const std::vector<char>& carga) = 0;
+
+    //bloqueia ate receber uma mensagem inteira; retorna false se o canal foi fechado
+    //ou se o cabecalho anuncia mais de TAMANHO_MAXIMO_CARGA bytes
+    virtual bool receber(Mensagem& mensagem) = 0;
+
+    //o mesmo, mas retorna false se a mensagem inteira nao chegar em tempo_espera_s segundos
+    //(depois disso o canal fica no meio de uma mensagem e nao deve mais ser usado)
+    virtual bool receber(Mensagem& mensagem, double tempo_espera_s) = 0;
+
+    //encerra o envio: o outro lado recebe o fim do canal depois das mensagens ja enviadas
+    virtual void encerrar_envio() = 0;
+};
+
+// Canal sobre um socket de fluxo (Unix ou TCP)
+class CanalSocket : public Canal {
+public:
+    explicit CanalSocket(int descritor) : descritor(descritor) {}
+    ~CanalSocket() override;
+
+    CanalSocket(const CanalSocket&) = delete;
+    CanalSocket& operator=(const CanalSocket&) = delete;
+
+    bool enviar(uint32_t tipo, const std::vector<char>& carga) override;
+    bool receber(Mensagem& mensagem) override;
+    bool receber(Mensagem& mensagem, double tempo_espera_s) override;
+    void encerrar_envio() override;
+
+private:
+    int descritor;
+    std::mutex mutex_envio; //mensagens de threads diferentes nao podem se intercalar no socket
+};
+
+// Servidor que aceita conexoes em um endereco:
+//   "unix:<caminho>"      socket de dominio Unix
+//   "tcp:<host>:<porta>"  socket TCP (ex: "tcp:127.0.0.1:5000")
+class ServidorCanais {
+public:
+    ServidorCanais() = default;
+    ~ServidorCanais();
+
+    ServidorCanais(const ServidorCanais&) = delete;
+    ServidorCanais& operator=(const ServidorCanais&) = delete;
+
+    bool escutar(const std::string& endereco);
+
+    //espera uma conexao ate tempo_espera_s segundos; retorna nullptr se o tempo acabou ou a conexao falhou
+    std::unique_ptr<Canal> aceitar(double tempo_espera_s);
+
+private:
+    int descritor = -1;
+    std::string caminho_unix; //removido ao destruir o servidor
+};
+
+// Conecta a um servidor, tentando de novo ate tempo_espera_s segundos (o servidor pode ainda nao estar escutando)
+std::unique_ptr<Canal> conectar_canal(const std::string& endereco, double tempo_espera_s);
+
+// Escrita e leitura de valores de tamanho fixo em uma carga
+struct EscritorCarga {
+    std::vector<char>& carga;
+
+    template <typename T>
+    void escrever(const T& valor) { escrever_bytes(&valor, sizeof(T)); }
+    void escrever_bytes(const void* dados, size_t tamanho) {
+        const char* bytes = static_cast<const char*>(dados);
+        carga.insert(carga.end(), bytes, bytes + tamanho);
+    }
+};
+
+struct LeitorCarga {
+    const std::vector<char>& carga;
+    size_t posicao = 0;
+
+    size_t restante() const { return carga.size() - posicao; }
+
+    //retorna false (sem ler) se a carga nao tem bytes suficientes
+    template <typename T>
+    bool ler(T& valor) { return ler_bytes(&valor, sizeof(T)); }
+    bool ler_bytes(void* destino, size_t tamanho) {
+        if (carga.size() - posicao < tamanho) return false;
+        std::memcpy(destino, carga.data() + posicao, tamanho);
+        posicao += tamanho;
+        return true;
+    }
+};
+
+#endif // TRANSPORTE_HPP